@@ -0,0 +1,141 @@
+/**
+ * @file
+ * @brief Benchmark of the conflict selection of cbs.
+ * The given map is tiled to the requested size, then on some random instances every agent gets a
+ * random task, and cbs solves them splitting its nodes on the first conflict and on the cardinal
+ * conflicts.
+ * Usage: bench_cbs MAP_PATH [ROWS] [COLUMNS] [AGENTS] [INSTANCES]
+ * @author Jacopo Zagoli
+ * @version 1.0
+ * @date November, 2022
+ * @copyright 2022 Jacopo Zagoli, Davide Furlani
+ */
+#include <fmt/format.h>
+
+#include <filesystem>
+#include <iostream>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "CmapdSolution.h"
+#include "Point.h"
+#include "Timer.hpp"
+#include "ambient/AmbientMap.h"
+#include "ambient/AmbientMapInstance.h"
+#include "bench_utils.h"
+#include "custom_types.h"
+#include "path_finders/ConflictSelection.h"
+#include "path_finders/cbs.h"
+
+/**
+ * Solves an instance with cbs.
+ * @param instance The instance.
+ * @param goal_sequences The goals of the agents.
+ * @param selection How cbs chooses the conflict on which a node is split.
+ * @param milliseconds Where the time spent by cbs is written.
+ * @return the solution.
+ * @throws runtime_error if cbs, multi A* or an MDD can't find the paths.
+ */
+cmapd::CmapdSolution measure(const cmapd::AmbientMapInstance& instance,
+                             const std::vector<cmapd::path_t>& goal_sequences,
+                             cmapd::cbs::ConflictSelection selection,
+                             double& milliseconds) {
+    timer::Timer<timer::HOST, timer::milli> timer;
+    timer.start();
+    try {
+        cmapd::CmapdSolution solution{
+            cmapd::cbs::cbs(instance, goal_sequences, cmapd::Planner::A_STAR, selection)};
+        timer.stop();
+        milliseconds = timer.duration();
+        return solution;
+    } catch (const std::runtime_error&) {
+        timer.stop();
+        throw;
+    }
+}
+
+/**
+ * @brief The benchmark entry point.
+ */
+int main(int argc, char* argv[]) {
+    using namespace cmapd;
+    if (argc < 2) {
+        std::cerr << "Usage: bench_cbs MAP_PATH [ROWS] [COLUMNS] [AGENTS] [INSTANCES]\n";
+        return EXIT_FAILURE;
+    }
+    const std::filesystem::path map_path{argv[1]};
+    const int rows{argc > 2 ? std::stoi(argv[2]) : 21};
+    const int columns{argc > 3 ? std::stoi(argv[3]) : 35};
+    const int n_agents{argc > 4 ? std::stoi(argv[4]) : 6};
+    const int n_instances{argc > 5 ? std::stoi(argv[5]) : 20};
+
+    const AmbientMap map{tiled_map(map_path, rows, columns)};
+    std::vector<Point> pois{random_pois(map, rows * columns)};
+    if (std::ssize(pois) < 3 * n_agents) {
+        std::cerr << "The map is too small for the agents and their tasks!\n";
+        return EXIT_FAILURE;
+    }
+
+    fmt::print("Map {}x{} with {} agents, {} instances\n", rows, columns, n_agents, n_instances);
+    std::mt19937 engine{42};
+    // only the instances solved by both the selections are counted
+    double first_time{0};
+    double cardinal_time{0};
+    int first_nodes{0};
+    int cardinal_nodes{0};
+    for (int i = 0; i < n_instances; ++i) {
+        // every agent goes to the pickup and then to the delivery of its task
+        std::shuffle(pois.begin(), pois.end(), engine);
+        std::vector<Point> agents;
+        std::vector<std::pair<Point, Point>> tasks;
+        std::vector<path_t> goal_sequences;
+        for (int agent = 0; agent < n_agents; ++agent) {
+            agents.push_back(pois[3 * agent]);
+            tasks.emplace_back(pois[3 * agent + 1], pois[3 * agent + 2]);
+            goal_sequences.push_back({agents.back(), tasks.back().first, tasks.back().second});
+        }
+        const AmbientMapInstance instance{map, agents, tasks};
+
+        double first_milliseconds{0};
+        double cardinal_milliseconds{0};
+        std::string_view run{"first"};
+        try {
+            const CmapdSolution first{measure(
+                instance, goal_sequences, cbs::ConflictSelection::FIRST, first_milliseconds)};
+            run = "cardinal";
+            const CmapdSolution cardinal{measure(instance,
+                                                 goal_sequences,
+                                                 cbs::ConflictSelection::CARDINAL,
+                                                 cardinal_milliseconds)};
+            if (first.cost != cardinal.cost) {
+                std::cerr << "The conflict selections found solutions of different cost!\n";
+                return EXIT_FAILURE;
+            }
+            first_time += first_milliseconds;
+            cardinal_time += cardinal_milliseconds;
+            first_nodes += first.expanded_nodes;
+            cardinal_nodes += cardinal.expanded_nodes;
+            fmt::print("instance {:3} cost {:5} expanded nodes: first {:7} cardinal {:7}\n",
+                       i,
+                       first.cost,
+                       first.expanded_nodes,
+                       cardinal.expanded_nodes);
+        } catch (const std::runtime_error& error) {
+            // the message starts with the component which failed: cbs, multi A* or an MDD
+            fmt::print("instance {:3} skipped, the {} run failed: {}\n", i, run, error.what());
+        }
+    }
+    fmt::print("{:>9} expanded nodes:{:9} total time:{:12.2f} ms\n",
+               "first",
+               first_nodes,
+               first_time);
+    fmt::print("{:>9} expanded nodes:{:9} total time:{:12.2f} ms\n",
+               "cardinal",
+               cardinal_nodes,
+               cardinal_time);
+    return 0;
+}
@@ -0,0 +1,142 @@
+/**
+ * @file
+ * @brief Microbenchmark of the memory and lookup throughput of the distance stores.
+ * The given map is tiled to the requested size and a set of points of interest is placed on it,
+ * then the distances are read from the h-table and from its compact copy, both at random and
+ * following random walks which read the distances of a cell and of its neighbours, like A*.
+ * Usage: bench_distance_storage MAP_PATH [ROWS] [COLUMNS] [POIS] [LOOKUPS]
+ * @author Jacopo Zagoli
+ * @version 1.0
+ * @date November, 2022
+ * @copyright 2022 Jacopo Zagoli, Davide Furlani
+ */
+#include <fmt/format.h>
+
+#include <cstdint>
+#include <filesystem>
+#include <iostream>
+#include <random>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "Point.h"
+#include "Timer.hpp"
+#include "ambient/AmbientMap.h"
+#include "ambient/AmbientMapInstance.h"
+#include "bench_utils.h"
+#include "custom_types.h"
+#include "distances/CompactDistanceTable.h"
+
+/// A distance to be read: a cell and the index of a point of interest.
+using query_t = std::pair<cmapd::Point, int>;
+
+/**
+ * Reads some distances from a store and prints the throughput.
+ * @param queries The distances to be read.
+ * @param name The name of the store.
+ * @param lookup The function reading a distance from the store.
+ * @return the sum of the distances read, to be compared between stores.
+ */
+template <typename Lookup>
+std::int64_t measure(const std::vector<query_t>& queries, std::string_view name, Lookup lookup) {
+    timer::Timer<timer::HOST, timer::milli> timer;
+    std::int64_t sum{0};
+    timer.start();
+    for (const auto& [point, poi] : queries) {
+        sum += lookup(point, poi);
+    }
+    timer.stop();
+    fmt::print("{:>14} {:10.2f} ms {:10.1f} Mlookups/s\n",
+               name,
+               timer.duration(),
+               static_cast<double>(queries.size()) / timer.duration() / 1000);
+    return sum;
+}
+
+/**
+ * Reads the same distances from the h-table and from its compact copy.
+ * @param queries The distances to be read.
+ * @param h_table The h-table.
+ * @param compact The compact copy of the h-table.
+ * @return true if the same distances are read.
+ */
+bool compare(const std::vector<query_t>& queries,
+             const cmapd::h_table_t& h_table,
+             const cmapd::CompactDistanceTable& compact) {
+    const auto dense_sum = measure(queries, "int", [&h_table](cmapd::Point point, int poi) {
+        return h_table.distance(h_table.cell_index(point), poi);
+    });
+    const auto compact_sum = measure(
+        queries, "uint16 tiles", [&compact](cmapd::Point point, int poi) {
+            return compact.distance(point, poi);
+        });
+    return dense_sum == compact_sum;
+}
+
+/**
+ * @brief The benchmark entry point.
+ */
+int main(int argc, char* argv[]) {
+    using namespace cmapd;
+    if (argc < 2) {
+        std::cerr << "Usage: bench_distance_storage MAP_PATH [ROWS] [COLUMNS] [POIS] [LOOKUPS]\n";
+        return EXIT_FAILURE;
+    }
+    const std::filesystem::path map_path{argv[1]};
+    const int rows{argc > 2 ? std::stoi(argv[2]) : 1000};
+    const int columns{argc > 3 ? std::stoi(argv[3]) : 1000};
+    const int n_pois{argc > 4 ? std::stoi(argv[4]) : 64};
+    const int lookups{argc > 5 ? std::stoi(argv[5]) : 10'000'000};
+
+    const AmbientMap map{tiled_map(map_path, rows, columns)};
+    const AmbientMapInstance instance{map, random_pois(map, n_pois), {}};
+    const h_table_t& h_table{instance.h_table()};
+    const CompactDistanceTable compact{h_table};
+
+    fmt::print("Map {}x{} with {} points of interest\n", rows, columns, h_table.num_pois());
+    fmt::print("{:>14} {:10.1f} MiB\n{:>14} {:10.1f} MiB\n",
+               "int",
+               static_cast<double>(h_table.memory_usage()) / (1 << 20),
+               "uint16 tiles",
+               static_cast<double>(compact.memory_usage()) / (1 << 20));
+
+    std::mt19937 engine{42};
+    std::uniform_int_distribution<int> random_row{0, rows - 1};
+    std::uniform_int_distribution<int> random_col{0, columns - 1};
+    std::uniform_int_distribution<int> random_poi{0, h_table.num_pois() - 1};
+    std::vector<query_t> queries;
+    queries.reserve(lookups);
+    while (std::ssize(queries) < lookups) {
+        const Point point{random_row(engine), random_col(engine)};
+        if (instance.is_valid(point)) queries.emplace_back(point, random_poi(engine));
+    }
+    fmt::print("Random lookups\n");
+    bool same{compare(queries, h_table, compact)};
+
+    // random walks of 1000 steps, reading the distances of every valid child of the current cell
+    queries.clear();
+    const moves_t moves{{0, 0}, {0, 1}, {1, 0}, {0, -1}, {-1, 0}};
+    std::uniform_int_distribution<int> random_move{1, 4};
+    while (std::ssize(queries) < lookups) {
+        const int poi{random_poi(engine)};
+        Point point{h_table.pois()[random_poi(engine)]};
+        for (int step = 0; step < 1000; ++step) {
+            for (const auto& move : moves) {
+                if (instance.is_valid(point + move)) queries.emplace_back(point + move, poi);
+            }
+            if (const Point next{point + moves[random_move(engine)]}; instance.is_valid(next)) {
+                point = next;
+            }
+        }
+    }
+    fmt::print("A* expansion lookups\n");
+    same = compare(queries, h_table, compact) && same;
+
+    if (!same) {
+        std::cerr << "The stores contain different distances!\n";
+        return EXIT_FAILURE;
+    }
+    return 0;
+}
@@ -0,0 +1,84 @@
+/**
+ * @file
+ * @brief Microbenchmark of the computation of the h-table.
+ * The given map is tiled to the requested size and a set of points of interest is placed on it,
+ * then the h-table is computed on a single thread and on the requested threads.
+ * Usage: bench_distances MAP_PATH [ROWS] [COLUMNS] [POIS] [THREADS] [REPETITIONS]
+ * @author Jacopo Zagoli
+ * @version 1.0
+ * @date November, 2022
+ * @copyright 2022 Jacopo Zagoli, Davide Furlani
+ */
+#include <fmt/format.h>
+
+#include <filesystem>
+#include <iostream>
+#include <string>
+
+#include "Timer.hpp"
+#include "ambient/AmbientMap.h"
+#include "ambient/AmbientMapInstance.h"
+#include "bench_utils.h"
+#include "custom_types.h"
+#include "distances/DistanceKernel.h"
+#include "distances/DistancesConfig.h"
+#include "distances/distances.h"
+
+/**
+ * Computes the h-table of an instance and prints the time it took.
+ * @param instance The instance.
+ * @param config The options used to compute the h-table.
+ * @param name The name of the kernel used.
+ * @param repetitions How many times the h-table is computed.
+ * @return the last computed h-table.
+ */
+cmapd::h_table_t measure(const cmapd::AmbientMapInstance& instance,
+                         const cmapd::DistancesConfig& config,
+                         std::string_view name,
+                         int repetitions) {
+    timer::Timer<timer::HOST, timer::milli> timer;
+    cmapd::h_table_t h_table;
+    for (int i = 0; i < repetitions; ++i) {
+        timer.start();
+        h_table = cmapd::compute_h_table(instance, config);
+        timer.stop();
+    }
+    fmt::print(
+        "{:>14} threads:{:3} mean time:{:12.2f} ms\n", name, config.threads, timer.average());
+    return h_table;
+}
+
+/**
+ * @brief The benchmark entry point.
+ */
+int main(int argc, char* argv[]) {
+    using namespace cmapd;
+    if (argc < 2) {
+        std::cerr << "Usage: bench_distances MAP_PATH [ROWS] [COLUMNS] [POIS] [THREADS] "
+                     "[REPETITIONS]\n";
+        return EXIT_FAILURE;
+    }
+    const std::filesystem::path map_path{argv[1]};
+    const int rows{argc > 2 ? std::stoi(argv[2]) : 1000};
+    const int columns{argc > 3 ? std::stoi(argv[3]) : 1000};
+    const int n_pois{argc > 4 ? std::stoi(argv[4]) : 256};
+    const int threads{argc > 5 ? std::stoi(argv[5]) : 4};
+    const int repetitions{argc > 6 ? std::stoi(argv[6]) : 3};
+
+    const AmbientMap map{tiled_map(map_path, rows, columns)};
+    const AmbientMapInstance instance{map, random_pois(map, n_pois), {}, {.threads = threads}};
+
+    fmt::print("Map {}x{} with {} points of interest\n",
+               rows,
+               columns,
+               instance.h_table().num_pois());
+    auto single = measure(
+        instance, {.threads = 1, .kernel = DistanceKernel::SCALAR}, "SCALAR", repetitions);
+    auto multi = measure(
+        instance, {.threads = threads, .kernel = DistanceKernel::SCALAR}, "SCALAR", repetitions);
+    if (single != multi) {
+        std::cerr << "The threads computed different h-tables!\n";
+        return EXIT_FAILURE;
+    }
+    return 0;
+}
@@ -0,0 +1,76 @@
+/**
+ * @file
+ * @brief Contains the functions used by the benchmarks to build big instances.
+ * @author Jacopo Zagoli
+ * @version 1.0
+ * @date November, 2022
+ * @copyright 2022 Jacopo Zagoli, Davide Furlani
+ */
+
+#pragma once
+#include <fmt/format.h>
+
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "Point.h"
+#include "ambient/AmbientMap.h"
+
+/**
+ * Builds a map obtained repeating the given one until it has the requested size.
+ * @param map_path The path to the map to be tiled.
+ * @param rows The number of rows of the tiled map.
+ * @param columns The number of columns of the tiled map.
+ * @return the tiled map.
+ * @throws runtime_error if the map file does not exist.
+ */
+inline cmapd::AmbientMap tiled_map(const std::filesystem::path& map_path, int rows, int columns) {
+    std::ifstream map_file{map_path};
+    if (!map_file) {
+        throw std::runtime_error{fmt::format("{}: file does non exist", map_path.string())};
+    }
+    std::vector<std::string> lines;
+    for (std::string line; std::getline(map_file, line);) {
+        lines.push_back(line);
+    }
+    const auto tiled_path{std::filesystem::temp_directory_path() / "cmapd_bench_map.txt"};
+    {
+        std::ofstream tiled_file{tiled_path};
+        for (int row = 0; row < rows; ++row) {
+            const auto& line = lines[row % lines.size()];
+            for (int col = 0; col < columns; ++col) {
+                tiled_file << line[col % line.size()];
+            }
+            tiled_file << '\n';
+        }
+    }
+    cmapd::AmbientMap map{tiled_path};
+    std::filesystem::remove(tiled_path);
+    return map;
+}
+
+/**
+ * Chooses some points of interest where agents could be generated, with a fixed seed.
+ * @param map The map.
+ * @param n_pois The number of points of interest.
+ * @return the points of interest, fewer than n_pois if the map is too small.
+ */
+inline std::vector<cmapd::Point> random_pois(const cmapd::AmbientMap& map, int n_pois) {
+    std::vector<cmapd::Point> possible_positions;
+    for (int row = 0; row < map.rows_number(); ++row) {
+        for (int col = 0; col < map.columns_number(); ++col) {
+            if (map.is_valid({row, col})) possible_positions.emplace_back(row, col);
+        }
+    }
+    std::mt19937 engine{42};
+    std::shuffle(possible_positions.begin(), possible_positions.end(), engine);
+    if (std::ssize(possible_positions) > n_pois) {
+        possible_positions.erase(possible_positions.begin() + n_pois, possible_positions.end());
+    }
+    return possible_positions;
+}
@@ -23,5 +23,7 @@ struct CmapdSolution {
     int makespan;
     /// The sum of all paths lengths
     int cost;
+    /// The number of high-level nodes expanded by the solver, zero if it doesn't search a tree.
+    int expanded_nodes{0};
 };
 }  // namespace cmapd
\ No newline at end of file
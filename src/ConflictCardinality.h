@@ -0,0 +1,28 @@
+/**
+ * @file
+ * @brief Contains the ConflictCardinality enum.
+ * @author Jacopo Zagoli
+ * @version 1.0
+ * @date November, 2022
+ * @copyright 2022 Jacopo Zagoli, Davide Furlani
+ */
+
+#pragma once
+
+namespace cmapd {
+
+/**
+ * @enum ConflictCardinality
+ * @brief Describes how much solving a conflict costs, according to the MDDs of its agents.
+ * @see ICBS: Improved Conflict-Based Search Algorithm for Multi-Agent Pathfinding.
+ */
+enum class ConflictCardinality {
+    /// The paths of both the agents get longer when the conflict is solved for either of them.
+    CARDINAL,
+    /// The path of only one of the agents gets longer when the conflict is solved for it.
+    SEMI_CARDINAL,
+    /// Both the agents have another path of the same length avoiding the conflict.
+    NON_CARDINAL
+};
+
+}  // namespace cmapd
@@ -0,0 +1,97 @@
+/**
+ * @file
+ * @brief Contains the implementation of the class ConstraintTable.
+ * @author Jacopo Zagoli
+ * @version 1.0
+ * @date November, 2022
+ * @copyright 2022 Jacopo Zagoli, Davide Furlani
+ */
+
+#include "a_star/ConstraintTable.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+#include "Constraint.h"
+#include "Point.h"
+#include "ambient/AmbientMapInstance.h"
+#include "hashing.h"
+
+namespace cmapd::multi_a_star {
+
+std::size_t ConstraintTable::MoveHash::operator()(const Move& move) const noexcept {
+    return hash_at_timestep(pack_pair(move.from, move.to), move.timestep);
+}
+
+ConstraintTable::ConstraintTable(const std::vector<Constraint>& constraints,
+                                 int agent,
+                                 const AmbientMapInstance& map_instance)
+    : m_map_instance{map_instance} {
+    for (const auto& constraint : constraints) {
+        if (constraint.agent != agent) continue;
+        const int from{m_map_instance.cell_index(constraint.from_position)};
+        const int to{m_map_instance.cell_index(constraint.to_position)};
+        if (constraint.final) {
+            // only the earliest final constraint of a move matters
+            const auto [it, inserted]
+                = m_final_moves.try_emplace(pack_pair(from, to), constraint.timestep);
+            if (!inserted) it->second = std::min(it->second, constraint.timestep);
+        } else {
+            m_moves.insert({constraint.timestep, from, to});
+            if (from == to) m_forbidden_waits[from].push_back(constraint.timestep);
+        }
+        m_last_timestep = std::max(m_last_timestep, constraint.timestep);
+    }
+}
+
+bool ConstraintTable::is_constrained(int timestep, Point from, Point to) const {
+    if (m_moves.empty() && m_final_moves.empty()) return false;
+    const int from_cell{m_map_instance.cell_index(from)};
+    const int to_cell{m_map_instance.cell_index(to)};
+    if (m_moves.contains({timestep, from_cell, to_cell})) return true;
+    // check for a previous final constraint
+    const auto it{m_final_moves.find(pack_pair(from_cell, to_cell))};
+    return it != m_final_moves.cend() && it->second <= timestep;
+}
+
+int ConstraintTable::last_timestep() const { return m_last_timestep; }
+
+std::vector<SafeInterval> ConstraintTable::safe_intervals(Point cell) const {
+    const int index{m_map_instance.cell_index(cell)};
+    int end{SafeInterval::forever};
+    if (const auto it{m_final_moves.find(pack_pair(index, index))}; it != m_final_moves.cend()) {
+        end = it->second - 1;
+    }
+    std::vector<int> forbidden_waits;
+    if (const auto it{m_forbidden_waits.find(index)}; it != m_forbidden_waits.cend()) {
+        forbidden_waits = it->second;
+    }
+    std::sort(forbidden_waits.begin(), forbidden_waits.end());
+    std::vector<SafeInterval> intervals;
+    int begin{0};
+    for (const int timestep : forbidden_waits) {
+        if (timestep > end) break;
+        // the agent can't wait from timestep - 1 to timestep, but can arrive from another cell
+        if (timestep > begin) {
+            intervals.push_back({begin, timestep - 1});
+            begin = timestep;
+        }
+    }
+    if (begin <= end) intervals.push_back({begin, end});
+    return intervals;
+}
+
+bool ConstraintTable::can_stay(Point cell, int timestep) const {
+    const int index{m_map_instance.cell_index(cell)};
+    if (m_final_moves.contains(pack_pair(index, index))) return false;
+    const auto it{m_forbidden_waits.find(index)};
+    return it == m_forbidden_waits.cend()
+           || std::none_of(it->second.cbegin(), it->second.cend(), [timestep](int forbidden) {
+                  return forbidden > timestep;
+              });
+}
+
+}  // namespace cmapd::multi_a_star
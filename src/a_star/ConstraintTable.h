@@ -0,0 +1,126 @@
+/**
+ * @file
+ * @brief Contains the class ConstraintTable.
+ * @author Jacopo Zagoli
+ * @version 1.0
+ * @date November, 2022
+ * @copyright 2022 Jacopo Zagoli, Davide Furlani
+ */
+
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "Constraint.h"
+#include "Point.h"
+#include "ambient/AmbientMapInstance.h"
+
+namespace cmapd::multi_a_star {
+
+/**
+ * @struct SafeInterval
+ * @brief A maximal range of timesteps in which an agent can stay in a cell, waiting from each
+ * timestep to the following one.
+ */
+struct SafeInterval {
+    /// The end of the intervals which never end.
+    static constexpr int forever{std::numeric_limits<int>::max()};
+    /// The first timestep of the interval.
+    int begin;
+    /// The last timestep of the interval, or forever.
+    int end;
+    /// Equality operator.
+    bool operator==(const SafeInterval& rhs) const = default;
+};
+
+/**
+ * @class ConstraintTable
+ * @brief The constraints of one agent, indexed by move, so that checking a move of a multi A*
+ * search takes constant time instead of a scan of all the constraints.
+ */
+class ConstraintTable {
+  private:
+    /**
+     * @struct Move
+     * @brief A move between two cells, at a given timestep.
+     */
+    struct Move {
+        /// The timestep in which the agent arrives in the destination cell.
+        int timestep;
+        /// The cell index of the starting cell.
+        int from;
+        /// The cell index of the destination cell.
+        int to;
+        /// Equality operator.
+        bool operator==(const Move& rhs) const = default;
+    };
+    /**
+     * @struct MoveHash
+     * @brief Hash function of a Move.
+     */
+    struct MoveHash {
+        /// Get the hash of a Move.
+        std::size_t operator()(const Move& move) const noexcept;
+    };
+
+    /// The map of the constrained moves.
+    const AmbientMapInstance& m_map_instance;
+    /// The moves forbidden at a single timestep.
+    std::unordered_set<Move, MoveHash> m_moves;
+    /// For the moves forbidden by a final constraint, packed by pack_pair, the first timestep in
+    /// which they are.
+    std::unordered_map<std::uint64_t, int> m_final_moves;
+    /// For every cell, the timesteps in which the agent can't wait in it, unsorted.
+    std::unordered_map<int, std::vector<int>> m_forbidden_waits;
+    /// The largest timestep of the constraints, or 0 if there are none.
+    int m_last_timestep{0};
+
+  public:
+    /**
+     * Indexes the constraints of an agent.
+     * @param constraints The constraints of all the agents.
+     * @param agent The agent whose constraints are indexed, the others are ignored.
+     * @param map_instance The map on which the agent moves, which must outlive the table.
+     */
+    ConstraintTable(const std::vector<Constraint>& constraints,
+                    int agent,
+                    const AmbientMapInstance& map_instance);
+    /**
+     * Check if a move is forbidden, either at its timestep or by an earlier final constraint.
+     * @param timestep The timestep in which the agent arrives in the destination cell.
+     * @param from The starting cell.
+     * @param to The destination cell.
+     * @return true if the move is constrained.
+     */
+    [[nodiscard]] bool is_constrained(int timestep, Point from, Point to) const;
+    /**
+     * Get the last timestep in which a constraint starts. After it, the constraints don't
+     * depend on time anymore.
+     * @return the largest timestep of the constraints, or 0 if there are none.
+     */
+    [[nodiscard]] int last_timestep() const;
+    /**
+     * Get the safe intervals of a cell, which split the time where a wait move in the cell is
+     * forbidden: an agent can arrive in the cell at any timestep of an interval, with a move
+     * that isn't constrained, and wait there until its end. A cell whose wait move is forbidden
+     * by a final constraint is unsafe from the timestep of the constraint on.
+     * @param cell A point inside the map.
+     * @return the safe intervals, sorted by time.
+     */
+    [[nodiscard]] std::vector<SafeInterval> safe_intervals(Point cell) const;
+    /**
+     * Check if the agent can stay in a cell forever, that is if no wait move in the cell is
+     * forbidden after a timestep. A path can end only in such a cell, since the agent stays in
+     * the last cell of its path.
+     * @param cell A point inside the map.
+     * @param timestep The timestep in which the agent arrives in the cell.
+     * @return true if the agent can wait in the cell at every timestep after timestep.
+     */
+    [[nodiscard]] bool can_stay(Point cell, int timestep) const;
+};
+
+}  // namespace cmapd::multi_a_star
@@ -8,45 +8,141 @@
  */
 #include "a_star/Frontier.h"
 
+#include <cstddef>
+#include <cstdint>
+#include <functional>
 #include <optional>
 #include <stdexcept>
+#include <utility>
 
+#include "Point.h"
 #include "a_star/Node.h"
 
 namespace cmapd::multi_a_star {
 
+std::size_t Frontier::StateHash::operator()(std::uint64_t state) const noexcept {
+    // the states of a cell differ only in the lower bits, the product spreads them on all the bits
+    return std::hash<std::uint64_t>{}(state * 0x9E3779B97F4A7C15ULL);
+}
+
+bool Frontier::precedes(const Node& lhs, const Node& rhs) {
+    if (lhs.get_f_value() != rhs.get_f_value()) return lhs.get_f_value() < rhs.get_f_value();
+    if (lhs.get_h_value() != rhs.get_h_value()) return lhs.get_h_value() < rhs.get_h_value();
+    if (lhs.get_g_value() != rhs.get_g_value()) return lhs.get_g_value() < rhs.get_g_value();
+    if (lhs.get_location() != rhs.get_location()) return lhs.get_location() < rhs.get_location();
+    return lhs.get_label() < rhs.get_label();
+}
+
+void Frontier::place(Entry&& entry, std::size_t position) {
+    m_index[entry.state] = position;
+    m_heap[position] = std::move(entry);
+}
+
+void Frontier::sift_up(std::size_t position) {
+    Entry entry{std::move(m_heap[position])};
+    while (position > 0) {
+        const std::size_t parent{(position - 1) / 2};
+        if (!precedes(entry.node, m_heap[parent].node)) break;
+        place(std::move(m_heap[parent]), position);
+        position = parent;
+    }
+    place(std::move(entry), position);
+}
+
+void Frontier::sift_down(std::size_t position) {
+    Entry entry{std::move(m_heap[position])};
+    while (true) {
+        std::size_t child{2 * position + 1};
+        if (child >= m_heap.size()) break;
+        if (child + 1 < m_heap.size() && precedes(m_heap[child + 1].node, m_heap[child].node)) {
+            ++child;
+        }
+        if (!precedes(m_heap[child].node, entry.node)) break;
+        place(std::move(m_heap[child]), position);
+        position = child;
+    }
+    place(std::move(entry), position);
+}
+
+std::optional<std::size_t> Frontier::find(std::uint64_t state) const {
+    const auto iter{m_index.find(state)};
+    if (iter == m_index.end()) return {};
+    return iter->second;
+}
+
+void Frontier::restore(std::size_t position) {
+    if (position > 0 && precedes(m_heap[position].node, m_heap[(position - 1) / 2].node)) {
+        sift_up(position);
+    } else {
+        sift_down(position);
+    }
+}
+
+void Frontier::erase(std::size_t position) {
+    m_index.erase(m_heap[position].state);
+    Entry last{std::move(m_heap.back())};
+    m_heap.pop_back();
+    if (position < m_heap.size()) {
+        place(std::move(last), position);
+        restore(position);
+    }
+}
+
 Node Frontier::pop() {
     if (empty()) throw std::runtime_error("The frontier is empty.");
-    Node best_node{
-        *std::min_element(m_queue.cbegin(), m_queue.cend(), [](const Node& a, const Node& b) {
-            return a.get_f_value() < b.get_f_value();
-        })};
-    m_queue.remove(best_node);
+    Node best_node{m_heap.front().node};
+    erase(0);
     return best_node;
 }
 
-void Frontier::replace(const Node& old_node, const Node& new_node) {
+void Frontier::replace(std::uint64_t old_state, const Node& new_node, std::uint64_t new_state) {
     if (empty()) throw std::runtime_error("The frontier is empty.");
-    if (m_queue.remove(old_node) == 0) {
-        throw std::runtime_error("old_node is not in the frontier.");
+    const auto position{find(old_state)};
+    if (!position) {
+        throw std::runtime_error("old_state is not in the frontier.");
+    }
+    if (old_state == new_state) {
+        m_heap[*position].node = new_node;
+        restore(*position);
+    } else {
+        erase(*position);
+        push(new_node, new_state);
     }
-    m_queue.push_front(new_node);
 }
 
-void Frontier::push(const Node& node) { m_queue.push_front(node); }
+bool Frontier::decrease_key(const Node& node, std::uint64_t state) {
+    const auto position{find(state)};
+    if (!position || m_heap[*position].node.get_f_value() <= node.get_f_value()) return false;
+    // the Node has the same state, so the index doesn't change
+    m_heap[*position].node = node;
+    sift_up(*position);
+    return true;
+}
 
-bool Frontier::contains(const Node& node) const {
-    return std::find(m_queue.cbegin(), m_queue.cend(), node) != m_queue.cend();
+void Frontier::push(const Node& node, std::uint64_t state) {
+    if (const auto position{find(state)}) {
+        // a Node of the same state is already in the frontier, the better one is kept
+        if (precedes(node, m_heap[*position].node)) {
+            m_heap[*position].node = node;
+            restore(*position);
+        }
+        return;
+    }
+    m_heap.push_back({node, state});
+    m_index[state] = m_heap.size() - 1;
+    sift_up(m_heap.size() - 1);
 }
 
-std::optional<Node> Frontier::contains_more_expensive(const Node& node, int cost) const {
-    auto iter = std::find_if(m_queue.cbegin(), m_queue.cend(), [node, cost](const Node& n_iter) {
-        return n_iter == node && n_iter.get_f_value() > cost;
-    });
-    if (iter == m_queue.cend()) return {};
-    return {*iter};
+bool Frontier::contains(std::uint64_t state) const { return m_index.contains(state); }
+
+std::optional<Node> Frontier::contains_more_expensive(std::uint64_t state, int cost) const {
+    const auto position{find(state)};
+    if (!position || m_heap[*position].node.get_f_value() <= cost) return {};
+    return {m_heap[*position].node};
 }
 
-bool Frontier::empty() const { return m_queue.empty(); }
+bool Frontier::empty() const { return m_heap.empty(); }
+
+std::size_t Frontier::size() const { return m_heap.size(); }
 
-}  // namespace cmapd::multi_a_star
\ No newline at end of file
+}  // namespace cmapd::multi_a_star
@@ -8,8 +8,11 @@
  */
 
 #pragma once
-#include <forward_list>
+#include <cstddef>
+#include <cstdint>
 #include <optional>
+#include <unordered_map>
+#include <vector>
 
 #include "a_star/Node.h"
 
@@ -19,18 +22,66 @@ namespace cmapd::multi_a_star {
  * @class Frontier
  * @brief This class is a sort of priority queue, which also allows to replace elements in it
  * and to test if an object is contained in the queue. For now it contains multi A* nodes.
+ * It's a binary heap with an index from the search state of every Node to its position in the
+ * heap, so that pushing, popping and replacing a Node take logarithmic time, and looking for a
+ * state constant time. States are packed by the caller with pack_state, like in StateSet, so
+ * Nodes in the same cell at the same timestep are distinct if they visited different goals.
+ * Nodes are ordered by f-value, then h-value, then g-value, location and finally label, so that
+ * the order in which they are popped doesn't depend on the order in which they are pushed.
  */
 class Frontier {
   private:
-    /// The underlying data structure containing the Nodes.
-    std::forward_list<Node> m_queue;
+    /**
+     * @struct Entry
+     * @brief A Node of the heap, with its state.
+     */
+    struct Entry {
+        /// The Node.
+        Node node;
+        /// The packed state of the Node.
+        std::uint64_t state;
+    };
+    /**
+     * @struct StateHash
+     * @brief Hash function of a packed state.
+     */
+    struct StateHash {
+        /// Get the hash of a packed state.
+        std::size_t operator()(std::uint64_t state) const noexcept;
+    };
+
+    /// The Nodes, as a binary heap: the children of the Node in position i are in 2i+1 and 2i+2.
+    std::vector<Entry> m_heap;
+    /// The position in m_heap of the Node of every state.
+    std::unordered_map<std::uint64_t, std::size_t, StateHash> m_index;
+
+    /// Test if a Node has to be popped before another one.
+    [[nodiscard]] static bool precedes(const Node& lhs, const Node& rhs);
+    /**
+     * Move a Node in a position of the heap, updating the index.
+     * @param entry The Node to be moved, with its state.
+     * @param position The position in the heap.
+     */
+    void place(Entry&& entry, std::size_t position);
+    /// Move a Node up towards the root of the heap, until its parent precedes it.
+    void sift_up(std::size_t position);
+    /// Move a Node down towards the leaves of the heap, until it precedes its children.
+    void sift_down(std::size_t position);
+    /// Move a Node up or down the heap, after it has been changed.
+    void restore(std::size_t position);
+    /// Remove the Node in a position of the heap.
+    void erase(std::size_t position);
+    /// Get the position in the heap of the Node of a state, if it's in the frontier.
+    [[nodiscard]] std::optional<std::size_t> find(std::uint64_t state) const;
 
   public:
     /**
-     * Insert a Node in the frontier.
+     * Insert a Node in the frontier. If a Node of the same state is already in it, the one which
+     * precedes the other is kept.
      * @param node The Node to be inserted.
+     * @param state The packed state of node.
      */
-    void push(const Node& node);
+    void push(const Node& node, std::uint64_t state);
     /**
      * Retrieve the Node with the minimum f-value in the frontier and remove it from the frontier.
      * @return The Node with the minimum f-value in the frontier.
@@ -38,19 +89,19 @@ class Frontier {
      */
     [[nodiscard]] Node pop();
     /**
-     * Test if a Node is present inside the frontier.
-     * @param node The Node to be searched in the frontier.
-     * @return True if the Node is present, false otherwise.
+     * Test if a Node of a state is present inside the frontier.
+     * @param state The packed state to be searched in the frontier.
+     * @return True if the state is present, false otherwise.
      */
-    [[nodiscard]] bool contains(const Node& node) const;
+    [[nodiscard]] bool contains(std::uint64_t state) const;
     /**
-     * Test if a Node is present inside the frontier, with a f-value greater than
+     * Test if a Node of a state is present inside the frontier, with a f-value greater than
      * the specified cost.
-     * @param node The Node to be searched in the frontier.
+     * @param state The packed state to be searched in the frontier.
      * @param cost The f-value to compare with Nodes in the frontier.
      * @return An optional containing a Node if found and nothing otherwise.
      */
-    [[nodiscard]] std::optional<Node> contains_more_expensive(const Node& node,
+    [[nodiscard]] std::optional<Node> contains_more_expensive(std::uint64_t state,
                                                                     int cost) const;
     /**
      * Test if the frontier is empty.
@@ -58,13 +109,28 @@ class Frontier {
      */
     [[nodiscard]] bool empty() const;
     /**
-     * Replace a given Node in the frontier with another one.
-     * @param old_node The Node to be replaced in the frontier.
+     * Get the number of Nodes in the frontier.
+     * @return the number of Nodes.
+     */
+    [[nodiscard]] std::size_t size() const;
+    /**
+     * Replace the Node of a given state in the frontier with another one.
+     * @param old_state The packed state of the Node to be replaced in the frontier.
      * @param new_node The Node which will replace the old one.
+     * @param new_state The packed state of new_node.
      * @throws runtime_error if the frontier is empty.
-     * @throws runtime_error if old_node is not in the frontier.
+     * @throws runtime_error if old_state is not in the frontier.
+     */
+    void replace(std::uint64_t old_state, const Node& new_node, std::uint64_t new_state);
+    /**
+     * Replace the Node of the same state as a given one, if it's in the frontier with a greater
+     * f-value. It's the same as replacing the result of contains_more_expensive(state, node
+     * f-value), without copying it.
+     * @param node The Node which will replace the more expensive one.
+     * @param state The packed state of node.
+     * @return true if a Node was replaced.
      */
-    void replace(const Node& old_node, const Node& new_node);
+    bool decrease_key(const Node& node, std::uint64_t state);
 };
 
 }  // namespace cmapd::multi_a_star
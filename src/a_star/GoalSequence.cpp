@@ -0,0 +1,47 @@
+/**
+ * @file
+ * @brief Contains the implementation of the multi A* GoalSequence.
+ * @author Jacopo Zagoli
+ * @version 1.0
+ * @date November, 2022
+ * @copyright 2022 Jacopo Zagoli, Davide Furlani
+ */
+
+#include "a_star/GoalSequence.h"
+
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "Point.h"
+#include "custom_types.h"
+
+namespace cmapd::multi_a_star {
+
+GoalSequence::GoalSequence(const h_table_t& h_table, const path_t& goals)
+    : m_h_table{&h_table},
+      m_goals{goals},
+      m_suffix_sums(goals.size() + 1, 0) {
+    for (const auto& goal : m_goals) {
+        m_poi_indexes.push_back(h_table.poi_index(goal));
+    }
+    for (int j = static_cast<int>(m_goals.size()) - 2; j >= 0; --j) {
+        const int distance{
+            h_table.distance(h_table.cell_index(m_goals[j]), m_poi_indexes[j + 1])};
+        if (distance == h_table_t::unreachable) {
+            throw std::out_of_range{"[multiastar] Goal " + std::to_string(j + 1)
+                                    + " can't be reached from goal " + std::to_string(j)};
+        }
+        m_suffix_sums[j] = m_suffix_sums[j + 1] + distance;
+    }
+}
+
+int GoalSequence::h_value(Point location, int label) const {
+    if (label >= static_cast<int>(m_goals.size())) return 0;
+    return m_h_table->distance(m_h_table->cell_index(location), m_poi_indexes[label])
+           + m_suffix_sums[label];
+}
+
+const path_t& GoalSequence::goals() const { return m_goals; }
+
+}  // namespace cmapd::multi_a_star
@@ -0,0 +1,55 @@
+/**
+ * @file
+ * @brief Contains the class GoalSequence in namespace multi_a_star.
+ * @author Jacopo Zagoli
+ * @version 1.0
+ * @date November, 2022
+ * @copyright 2022 Jacopo Zagoli, Davide Furlani
+ */
+
+#pragma once
+#include <vector>
+
+#include "Point.h"
+#include "custom_types.h"
+
+namespace cmapd::multi_a_star {
+
+/**
+ * @class GoalSequence
+ * @brief The goals visited by a multi A* search, with the distances needed by its heuristic.
+ * The distance from every goal to the end of the sequence is computed once, so the h-value of a
+ * node costs a single h-table lookup, whatever the length of the sequence.
+ * @see Lifelong Multi-Agent Path Finding in Large-Scale Warehouses, section 4.1
+ */
+class GoalSequence {
+  private:
+    /// The h-table of the map instance.
+    const h_table_t* m_h_table;
+    /// The goals to visit.
+    path_t m_goals;
+    /// For every goal, its index in the h-table.
+    std::vector<int> m_poi_indexes;
+    /// For every label, the length of the path visiting the goals from the label-th to the last.
+    std::vector<int> m_suffix_sums;
+
+  public:
+    /**
+     * Constructs the goal sequence, computing the suffix sums of the distances between goals.
+     * @param h_table The h-table of the map instance, it must outlive the goal sequence.
+     * @param goals The goals to visit, they must be points of interest of the h-table.
+     * @throws out_of_range if a goal can't be reached from the previous one.
+     */
+    GoalSequence(const h_table_t& h_table, const path_t& goals);
+    /**
+     * Computes an estimated distance of a Point from the goals still to visit.
+     * @param location The point from which the distance is calculated.
+     * @param label The number of goals already visited.
+     * @return The distance of location to the goals, according to label.
+     */
+    [[nodiscard]] int h_value(Point location, int label) const;
+    /// Get the goals to visit.
+    [[nodiscard]] const path_t& goals() const;
+};
+
+}  // namespace cmapd::multi_a_star
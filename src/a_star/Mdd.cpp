@@ -0,0 +1,114 @@
+/**
+ * @file
+ * @brief Contains the implementation of the class Mdd.
+ * @author Jacopo Zagoli
+ * @version 1.0
+ * @date November, 2022
+ * @copyright 2022 Jacopo Zagoli, Davide Furlani
+ */
+
+#include "a_star/Mdd.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "Constraint.h"
+#include "Point.h"
+#include "a_star/ConstraintTable.h"
+#include "a_star/GoalSequence.h"
+#include "custom_types.h"
+
+namespace cmapd::multi_a_star {
+
+Mdd::Mdd(int agent,
+         Point start_location,
+         const path_t& goal_sequence,
+         int cost,
+         const AmbientMapInstance& map_instance,
+         const std::vector<Constraint>& constraints) {
+    if (goal_sequence.empty()) {
+        m_layers.push_back({start_location});
+        return;
+    }
+    const ConstraintTable constraint_table{constraints, agent, map_instance};
+    const GoalSequence goals{map_instance.h_table(), goal_sequence};
+    const int n_goals{static_cast<int>(std::ssize(goal_sequence))};
+    // the number of goals visited after arriving in a cell, with the given ones before
+    const auto visit = [&](Point location, int label) {
+        return label < n_goals && location == goal_sequence[label] ? label + 1 : label;
+    };
+    // a node of a layer: a cell and the number of goals visited, including the one in the cell
+    using node_t = std::pair<Point, int>;
+    std::vector<std::vector<node_t>> layers{{{start_location, visit(start_location, 0)}}};
+    // for every layer but the last, the edges to the nodes of the following one
+    std::vector<std::vector<std::pair<int, int>>> edges;
+    // going forward, only the nodes from which the goals can still be visited in time
+    for (int timestep = 0; timestep < cost; ++timestep) {
+        std::unordered_map<std::uint64_t, int> indexes;
+        auto& next_layer{layers.emplace_back()};
+        auto& layer_edges{edges.emplace_back()};
+        const auto& layer{layers[timestep]};
+        for (int index = 0; index < std::ssize(layer); ++index) {
+            const auto [location, label] = layer[index];
+            for (const int cell : map_instance.neighbours(location)) {
+                const Point next{map_instance.cell_point(cell)};
+                const int next_label{visit(next, label)};
+                if (timestep + 1 + goals.h_value(next, next_label) > cost
+                    || constraint_table.is_constrained(timestep + 1, location, next)) {
+                    continue;
+                }
+                const auto key{static_cast<std::uint64_t>(cell) * (n_goals + 1) + next_label};
+                const auto [it, inserted]
+                    = indexes.try_emplace(key, static_cast<int>(next_layer.size()));
+                if (inserted) next_layer.emplace_back(next, next_label);
+                layer_edges.emplace_back(index, it->second);
+            }
+        }
+    }
+    // going backward, only the nodes which lead to the last goal, after the other ones, if the
+    // agent can stay there after the end of its path
+    const bool can_stay{constraint_table.can_stay(goal_sequence.back(), cost)};
+    std::vector<bool> alive(layers[cost].size());
+    for (int index = 0; index < std::ssize(layers[cost]); ++index) {
+        alive[index] = can_stay && layers[cost][index] == node_t{goal_sequence.back(), n_goals};
+    }
+    m_layers.resize(cost + 1);
+    for (int timestep = cost; timestep >= 0; --timestep) {
+        for (int index = 0; index < std::ssize(layers[timestep]); ++index) {
+            if (alive[index]) m_layers[timestep].push_back(layers[timestep][index].first);
+        }
+        std::sort(m_layers[timestep].begin(), m_layers[timestep].end());
+        m_layers[timestep].erase(
+            std::unique(m_layers[timestep].begin(), m_layers[timestep].end()),
+            m_layers[timestep].end());
+        if (m_layers[timestep].empty()) {
+            throw std::runtime_error{"[mdd] No path of cost " + std::to_string(cost)
+                                     + " for agent " + std::to_string(agent)};
+        }
+        if (timestep == 0) break;
+        std::vector<bool> previous_alive(layers[timestep - 1].size());
+        for (const auto& [parent, child] : edges[timestep - 1]) {
+            if (alive[child]) previous_alive[parent] = true;
+        }
+        alive = std::move(previous_alive);
+    }
+}
+
+int Mdd::cost() const { return static_cast<int>(m_layers.size()) - 1; }
+
+const std::vector<Point>& Mdd::cells(int timestep) const {
+    return m_layers[std::min(timestep, cost())];
+}
+
+bool Mdd::is_singleton(int timestep, Point cell) const {
+    const auto& layer{cells(timestep)};
+    return layer.size() == 1 && layer.front() == cell;
+}
+
+}  // namespace cmapd::multi_a_star
@@ -0,0 +1,71 @@
+/**
+ * @file
+ * @brief Contains the class Mdd.
+ * @author Jacopo Zagoli
+ * @version 1.0
+ * @date November, 2022
+ * @copyright 2022 Jacopo Zagoli, Davide Furlani
+ */
+
+#pragma once
+#include <vector>
+
+#include "Constraint.h"
+#include "Point.h"
+#include "ambient/AmbientMapInstance.h"
+#include "custom_types.h"
+
+namespace cmapd::multi_a_star {
+
+/**
+ * @class Mdd
+ * @brief A Multi-valued Decision Diagram: the cells where an agent can be at every timestep, on
+ * one of its shortest paths through its goals which respect its constraints. A node of a layer is
+ * a cell together with the number of goals already visited, and only the cells are kept.
+ * @see The increasing cost tree search for optimal multi-agent pathfinding.
+ * @see ICBS: Improved Conflict-Based Search Algorithm for Multi-Agent Pathfinding.
+ */
+class Mdd {
+  private:
+    /// For every timestep, the cells of the nodes of the layer, sorted.
+    std::vector<std::vector<Point>> m_layers;
+
+  public:
+    /**
+     * Builds the MDD of the paths of a given cost.
+     * @param agent The agent.
+     * @param start_location The start location of the agent.
+     * @param goal_sequence The sequence of goals to be visited.
+     * @param cost The number of moves of the shortest paths, that is their length minus one.
+     * @param map_instance The AmbientMapInstance on which the agents are moving.
+     * @param constraints The constraints to be respected by the paths.
+     * @throws runtime_error if there are no paths of the given cost.
+     */
+    Mdd(int agent,
+        Point start_location,
+        const path_t& goal_sequence,
+        int cost,
+        const AmbientMapInstance& map_instance,
+        const std::vector<Constraint>& constraints);
+    /**
+     * Get the number of moves of the paths.
+     * @return the cost of the paths.
+     */
+    [[nodiscard]] int cost() const;
+    /**
+     * Get the cells where the agent can be at a timestep. After the end of the paths, the agent
+     * stays in its last goal.
+     * @param timestep The timestep.
+     * @return the cells, sorted.
+     */
+    [[nodiscard]] const std::vector<Point>& cells(int timestep) const;
+    /**
+     * Test if all the paths go through a cell at a timestep.
+     * @param timestep The timestep.
+     * @param cell The cell.
+     * @return true if cell is the only one of the layer of timestep.
+     */
+    [[nodiscard]] bool is_singleton(int timestep, Point cell) const;
+};
+
+}  // namespace cmapd::multi_a_star
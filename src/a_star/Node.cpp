@@ -10,48 +10,36 @@
 #include "a_star/Node.h"
 
 #include "Point.h"
+#include "a_star/GoalSequence.h"
 #include "ambient/AmbientMapInstance.h"
 #include "custom_types.h"
-#include "distances/distances.h"
 
 namespace cmapd::multi_a_star {
 
-Node::Node(const Point loc, const h_table_t& h_table, const path_t& goal_sequence)
+Node::Node(const Point loc, const GoalSequence& goals)
     : m_location{loc},
-      m_path{{loc}},
+      m_parent{no_parent},
       m_label{0},
       m_g{0},
-      m_h{cmapd::multi_a_star::compute_h_value(loc, m_label, h_table, goal_sequence)},
-      m_h_table{h_table},
-      m_goal_sequence{goal_sequence} {}
-
-Node::Node(const Point loc,
-           const Node& parent,
-           const h_table_t& h_table,
-           const path_t& goal_sequence)
+      m_h{goals.h_value(loc, m_label)},
+      m_goals{&goals} {}
+
+Node::Node(const Point loc, const Node& parent, int parent_index)
     : m_location{loc},
-      m_path{parent.get_path()},
+      m_parent{parent_index},
       m_label{parent.m_label},
       m_g{parent.m_g + 1},
-      m_h{cmapd::multi_a_star::compute_h_value(loc, parent.m_label, h_table, goal_sequence)},
-      m_h_table{h_table},
-      m_goal_sequence{goal_sequence} {
-    m_path.push_back(m_location);
-}
+      m_h{parent.m_goals->h_value(loc, parent.m_label)},
+      m_goals{parent.m_goals} {}
 
-std::vector<Node> Node::get_children(const AmbientMapInstance& instance) const {
+std::vector<Node> Node::get_children(const AmbientMapInstance& instance, int index) const {
     std::vector<Node> children;
-    for (moves_t moves{{0, 0}, {0, 1}, {1, 0}, {0, -1}, {-1, 0}}; const auto& move : moves) {
-        Point new_position = m_location + move;
-        if (instance.is_valid(new_position)) {
-            children.emplace_back(new_position, *this, m_h_table, m_goal_sequence);
-        }
+    for (const int cell : instance.neighbours(m_location)) {
+        children.emplace_back(instance.cell_point(cell), *this, index);
     }
     return children;
 }
 
-path_t Node::get_path() const { return m_path; }
-
 std::partial_ordering Node::operator<=>(const Node& rhs) const {
     if (auto c = get_location() <=> rhs.get_location(); c != nullptr) return c;
     return m_g <=> rhs.m_g;
@@ -63,6 +51,8 @@ bool Node::operator==(const Node& rhs) const {
 
 const Point& Node::get_location() const { return m_location; }
 
+int Node::get_parent() const { return m_parent; }
+
 int Node::get_label() const { return m_label; }
 
 void Node::increment_label() { m_label++; }
@@ -71,4 +61,6 @@ int Node::get_f_value() const { return m_g + m_h; }
 
 int Node::get_g_value() const { return m_g; }
 
+int Node::get_h_value() const { return m_h; }
+
 }  // namespace cmapd::multi_a_star
\ No newline at end of file
@@ -12,70 +12,68 @@
 #include <vector>
 
 #include "Point.h"
+#include "a_star/GoalSequence.h"
 #include "ambient/AmbientMapInstance.h"
-#include "custom_types.h"
 
 namespace cmapd::multi_a_star {
 
 /**
  * @class Node
  * @brief This class represents a Node that is used in the multi A* search algorithm.
+ * Nodes are small: the path from the root is not stored, but it can be reconstructed from the
+ * parents kept in a NodePool.
  * @see Lifelong Multi-Agent Path Finding in Large-Scale Warehouses.
+ * @see NodePool
  */
 class Node {
-  private:
+ public:
+   /// The parent index of the root Node.
+   static constexpr int no_parent{-1};
+
+ private:
     /// A location on the map.
    Point m_location;
-   /// The path from root to the current node. For root is root itself.
-   path_t m_path;
+   /// The index of the parent Node in the NodePool of the search, or no_parent for the root.
+   int m_parent;
    /// The number of goal locations in goal_sequence that the current A* path has already visited.
    int m_label;
    /// The cost of the path until the current Node.
    int m_g;
    /// The estimated cost of visiting the goals from the current Node.
    int m_h;
-   /// A reference to the h-table, useful for generating other nodes.
-   h_table_t m_h_table;
-   /// Goal to visit.
-   path_t m_goal_sequence;
+   /// The goals to visit with their distances, shared by all the nodes of a search.
+   const GoalSequence* m_goals;
 
  public:
    /**
     * Constructor for the root Node.
     * @param loc Position on the map.
-    * @param h_table A reference to the h-table for the current map.
-    * @param goal_sequence The goals to visit.
+    * @param goals The goals to visit, they must outlive the Node and its children.
     */
-   explicit Node(Point loc, const h_table_t& h_table, const path_t& goal_sequence);
+   explicit Node(Point loc, const GoalSequence& goals);
    /**
-    * Constructor for a Node with a parent.
+    * Constructor for a Node with a parent. It visits the same goals of the parent.
     * @param loc Position on the map.
     * @param parent A reference to the parent Node.
-    * @param h_table A reference to the h-table for the current map.
-    * @param goal_sequence The goals to visit.
+    * @param parent_index The index of the parent Node in the NodePool of the search.
     */
-   explicit Node(Point loc,
-                 const Node& parent,
-                 const h_table_t& h_table,
-                 const path_t& goal_sequence);
+   explicit Node(Point loc, const Node& parent, int parent_index);
    /**
     * This method returns all children in valid positions of a Node with all the parameters set.
     * @param instance The map used to find the path.
+    * @param index The index of this Node in the NodePool of the search.
     * @return A vector of child Nodes.
     */
-   [[nodiscard]] std::vector<Node> get_children(const AmbientMapInstance& instance) const;
-   /**
-    * This method returns the positions from the parent to the current Node following the path.
-    * The parent and the current node are included.
-    * @return A vector of Points.
-    */
-   [[nodiscard]] path_t get_path() const;
+   [[nodiscard]] std::vector<Node> get_children(const AmbientMapInstance& instance,
+                                                int index) const;
    /// Comparison between nodes based on their f-value.
    [[nodiscard]] std::partial_ordering operator<=>(const Node& rhs) const;
    /// Equality operator between nodes. It compares location and g-value (used as timestep).
    [[nodiscard]] bool operator==(const Node& rhs) const;
    /// Location getter.
    [[nodiscard]] const Point& get_location() const;
+   /// Parent index getter.
+   [[nodiscard]] int get_parent() const;
    /// Label getter.
    [[nodiscard]] int get_label() const;
    /// Increment label value by one.
@@ -84,6 +82,8 @@ class Node {
    [[nodiscard]] int get_f_value() const;
    /// Get the g-value of the node.
    [[nodiscard]] int get_g_value() const;
+   /// Get the h-value of the node.
+   [[nodiscard]] int get_h_value() const;
 };
 
 }  // namespace cmapd::multi_a_star
\ No newline at end of file
@@ -0,0 +1,42 @@
+/**
+ * @file
+ * @brief Contains the implementation of the class NodePool.
+ * @author Jacopo Zagoli
+ * @version 1.0
+ * @date November, 2022
+ * @copyright 2022 Jacopo Zagoli, Davide Furlani
+ */
+
+#include "a_star/NodePool.h"
+
+#include <algorithm>
+#include <vector>
+
+#include "a_star/Node.h"
+#include "custom_types.h"
+
+namespace cmapd::multi_a_star {
+
+int NodePool::add(const Node& node) {
+    m_nodes.push_back(node);
+    return size() - 1;
+}
+
+const Node& NodePool::operator[](int index) const { return m_nodes[index]; }
+
+int NodePool::size() const { return static_cast<int>(m_nodes.size()); }
+
+path_t NodePool::path(const Node& node) const {
+    // the g-value is the number of moves from the root
+    path_t path;
+    path.reserve(node.get_g_value() + 1);
+    path.push_back(node.get_location());
+    for (int parent = node.get_parent(); parent != Node::no_parent;
+         parent = m_nodes[parent].get_parent()) {
+        path.push_back(m_nodes[parent].get_location());
+    }
+    std::reverse(path.begin(), path.end());
+    return path;
+}
+
+}  // namespace cmapd::multi_a_star
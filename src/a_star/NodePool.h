@@ -0,0 +1,55 @@
+/**
+ * @file
+ * @brief Contains the class NodePool.
+ * @author Jacopo Zagoli
+ * @version 1.0
+ * @date November, 2022
+ * @copyright 2022 Jacopo Zagoli, Davide Furlani
+ */
+
+#pragma once
+#include <vector>
+
+#include "a_star/Node.h"
+#include "custom_types.h"
+
+namespace cmapd::multi_a_star {
+
+/**
+ * @class NodePool
+ * @brief Keeps the expanded Nodes of a multi A* search, so that every Node refers to its parent
+ * with an index instead of keeping the whole path from the root.
+ */
+class NodePool {
+  private:
+    /// The Nodes, in the order in which they were added.
+    std::vector<Node> m_nodes;
+
+  public:
+    /**
+     * Add a Node to the pool.
+     * @param node The Node to be added.
+     * @return the index of the Node, to be used as the parent index of its children.
+     */
+    int add(const Node& node);
+    /**
+     * Get a Node of the pool.
+     * @param index The index of the Node.
+     * @return the Node.
+     */
+    [[nodiscard]] const Node& operator[](int index) const;
+    /**
+     * Get the number of Nodes in the pool.
+     * @return the number of Nodes.
+     */
+    [[nodiscard]] int size() const;
+    /**
+     * Reconstruct the positions from the root to a Node, following the parents in the pool.
+     * The root and the Node are included.
+     * @param node A Node whose parent, if any, is in the pool.
+     * @return A vector of Points.
+     */
+    [[nodiscard]] path_t path(const Node& node) const;
+};
+
+}  // namespace cmapd::multi_a_star
@@ -0,0 +1,25 @@
+/**
+ * @file
+ * @brief Contains the Planner enum.
+ * @author Jacopo Zagoli
+ * @version 1.0
+ * @date November, 2022
+ * @copyright 2022 Jacopo Zagoli, Davide Furlani
+ */
+
+#pragma once
+
+namespace cmapd {
+
+/**
+ * @enum Planner
+ * @brief Describes the algorithm used to find the path of a single agent.
+ */
+enum class Planner {
+    /// Multi A* over the cells and the timesteps, which expands a node for every wait move.
+    A_STAR,
+    /// Multi-goal Safe Interval Path Planning, which expands a node for every safe interval.
+    SIPP
+};
+
+}  // namespace cmapd
@@ -0,0 +1,61 @@
+/**
+ * @file
+ * @brief Contains the implementation of the class StateSet.
+ * @author Jacopo Zagoli
+ * @version 1.0
+ * @date November, 2022
+ * @copyright 2022 Jacopo Zagoli, Davide Furlani
+ */
+
+#include "a_star/StateSet.h"
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace cmapd::multi_a_star {
+
+StateSet::StateSet(std::size_t capacity)
+    // the load factor is kept below one half
+    : m_slots(std::bit_ceil(2 * capacity + 2), empty_slot) {}
+
+std::size_t StateSet::home_slot(std::uint64_t state) const {
+    // Fibonacci hashing: the upper bits of the product depend on all the bits of the state
+    const int shift{std::countl_zero(m_slots.size()) + 1};
+    return static_cast<std::size_t>((state * 0x9E3779B97F4A7C15ULL) >> shift);
+}
+
+void StateSet::grow() {
+    std::vector<std::uint64_t> old_slots(2 * m_slots.size(), empty_slot);
+    old_slots.swap(m_slots);
+    m_size = 0;
+    for (const auto state : old_slots) {
+        if (state != empty_slot) insert(state);
+    }
+}
+
+bool StateSet::insert(std::uint64_t state) {
+    if (2 * (m_size + 1) > m_slots.size()) grow();
+    const std::size_t mask{m_slots.size() - 1};
+    for (std::size_t slot{home_slot(state)};; slot = (slot + 1) & mask) {
+        if (m_slots[slot] == state) return false;
+        if (m_slots[slot] == empty_slot) {
+            m_slots[slot] = state;
+            ++m_size;
+            return true;
+        }
+    }
+}
+
+bool StateSet::contains(std::uint64_t state) const {
+    const std::size_t mask{m_slots.size() - 1};
+    for (std::size_t slot{home_slot(state)};; slot = (slot + 1) & mask) {
+        if (m_slots[slot] == state) return true;
+        if (m_slots[slot] == empty_slot) return false;
+    }
+}
+
+std::size_t StateSet::size() const { return m_size; }
+
+}  // namespace cmapd::multi_a_star
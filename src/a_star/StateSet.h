@@ -0,0 +1,85 @@
+/**
+ * @file
+ * @brief Contains the class StateSet and the packing of multi A* search states.
+ * @author Jacopo Zagoli
+ * @version 1.0
+ * @date November, 2022
+ * @copyright 2022 Jacopo Zagoli, Davide Furlani
+ */
+
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+namespace cmapd::multi_a_star {
+
+/// The number of bits of the goal label in a packed state.
+inline constexpr int state_label_bits{12};
+/// The number of bits of the timestep in a packed state.
+inline constexpr int state_timestep_bits{20};
+/// The largest goal label of a packed state.
+inline constexpr int max_state_label{(1 << state_label_bits) - 1};
+/// The timestep of the packed states which don't depend on time. Larger timesteps can't be packed.
+inline constexpr int any_timestep{(1 << state_timestep_bits) - 1};
+
+/**
+ * Packs a search state in 64 bits: the cell in the upper 32 bits, then the goal label and the
+ * timestep.
+ * @param cell The cell index of the location.
+ * @param timestep The timestep, at most any_timestep.
+ * @param label The number of goals already visited, at most max_state_label.
+ * @return the packed state.
+ */
+[[nodiscard]] constexpr std::uint64_t pack_state(int cell, int timestep, int label) {
+    return static_cast<std::uint64_t>(static_cast<std::uint32_t>(cell)) << 32
+           | static_cast<std::uint64_t>(label) << state_timestep_bits
+           | static_cast<std::uint64_t>(timestep);
+}
+
+/**
+ * @class StateSet
+ * @brief A set of packed states, stored in a flat hash table with open addressing and linear
+ * probing, so that looking for a state reads a few contiguous slots instead of walking a tree.
+ */
+class StateSet {
+  private:
+    /// The value of the empty slots, which is not a valid packed state.
+    static constexpr std::uint64_t empty_slot{std::numeric_limits<std::uint64_t>::max()};
+    /// The slots, their number is a power of two.
+    std::vector<std::uint64_t> m_slots;
+    /// The number of states in the set.
+    std::size_t m_size{0};
+
+    /// Get the slot where the search for a state starts.
+    [[nodiscard]] std::size_t home_slot(std::uint64_t state) const;
+    /// Double the number of slots, inserting again all the states.
+    void grow();
+
+  public:
+    /**
+     * Constructs an empty set.
+     * @param capacity The number of states which can be inserted before the set grows.
+     */
+    explicit StateSet(std::size_t capacity = 1024);
+    /**
+     * Insert a state in the set.
+     * @param state A packed state.
+     * @return true if the state was not in the set.
+     */
+    bool insert(std::uint64_t state);
+    /**
+     * Test if a state is in the set.
+     * @param state A packed state.
+     * @return true if the state is in the set.
+     */
+    [[nodiscard]] bool contains(std::uint64_t state) const;
+    /**
+     * Get the number of states in the set.
+     * @return the number of states.
+     */
+    [[nodiscard]] std::size_t size() const;
+};
+
+}  // namespace cmapd::multi_a_star
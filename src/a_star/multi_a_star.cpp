@@ -9,51 +9,25 @@
 
 #include "a_star/multi_a_star.h"
 
-#include <set>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+#include <vector>
 
 #include "Constraint.h"
 #include "Point.h"
+#include "a_star/ConstraintTable.h"
 #include "a_star/Frontier.h"
+#include "a_star/GoalSequence.h"
 #include "a_star/Node.h"
+#include "a_star/NodePool.h"
+#include "a_star/Planner.h"
+#include "a_star/StateSet.h"
+#include "a_star/sipp.h"
 #include "custom_types.h"
 
 namespace cmapd::multi_a_star {
 
-/**
- * Check if an A* Node is present in the constraint list.
- * @param constraints The list of constraints.
- * @param agent The agent which we are checking.
- * @param child The node to be checked.
- * @param parent The parent of child.
- * @return true if child is constrained.
- */
-bool is_constrained(const std::vector<Constraint>& constraints,
-                    int agent,
-                    const Node& child,
-                    const Node& parent) {
-    // create the constraint to be checked
-    Constraint check_me{.agent = agent,
-                        .timestep = child.get_g_value(),
-                        .from_position = parent.get_location(),
-                        .to_position = child.get_location()};
-    if (std::find(constraints.cbegin(), constraints.cend(), check_me) != constraints.cend()) {
-        return true;
-    }
-    // check for a previous final constraint
-    if (std::find_if(constraints.cbegin(),
-                     constraints.cend(),
-                     [&check_me](const Constraint& constraint) -> bool {
-                         return constraint.final && check_me.agent == constraint.agent
-                                && constraint.timestep <= check_me.timestep
-                                && check_me.from_position == constraint.from_position
-                                && check_me.to_position == constraint.to_position;
-                     })
-        != constraints.cend()) {
-        return true;
-    }
-    return false;
-}
-
 path_t multi_a_star(int agent,
                     Point start_location,
                     const path_t& goal_sequence,
@@ -68,12 +42,35 @@ path_t multi_a_star(int agent,
     if (goal_sequence.empty()) {
         return path_t{start_location};
     }
+    // the constraints of the agent, indexed once for all the generated children
+    const ConstraintTable constraint_table{constraints, agent, map_instance};
+    // after the last constrained timestep, the time doesn't matter anymore: a state reached later
+    // than an explored one can't lead to a better path
+    const int last_constrained_timestep{constraint_table.last_timestep()};
+    if (last_constrained_timestep >= any_timestep || std::ssize(goal_sequence) > max_state_label) {
+        throw std::overflow_error("[multiastar] The search states can't be packed in 64 bits.");
+    }
+    // the state of a node, including the goal in its location as already visited
+    const auto state = [&](const Node& node) {
+        int label{node.get_label()};
+        if (label < std::ssize(goal_sequence) && node.get_location() == goal_sequence[label]) {
+            ++label;
+        }
+        const int timestep{node.get_g_value() < last_constrained_timestep ? node.get_g_value()
+                                                                           : any_timestep};
+        return pack_state(map_instance.cell_index(node.get_location()), timestep, label);
+    };
     // frontier definition
     Frontier frontier;
     // explore set definition
-    std::set<Node> explored;
+    StateSet explored;
+    // the expanded nodes, which are the parents of the following ones
+    NodePool pool;
+    // the distances between goals are computed once for all the nodes
+    const GoalSequence goals{map_instance.h_table(), goal_sequence};
     // generation of root node in the frontier
-    frontier.push(Node{start_location, map_instance.h_table(), goal_sequence});
+    const Node root{start_location, goals};
+    frontier.push(root, state(root));
     // main loop
     while (!frontier.empty()) {
         // timeout operations
@@ -84,25 +81,32 @@ path_t multi_a_star(int agent,
         }
         // get top node
         auto top_node{frontier.pop()};
+        const auto top_state{state(top_node)};
         // Update label
-        if (top_node.get_location() == goal_sequence[top_node.get_label()]) {
+        if (top_node.get_label() < std::ssize(goal_sequence)
+            && top_node.get_location() == goal_sequence[top_node.get_label()]) {
             top_node.increment_label();
         }
-        // Goal test
-        if (top_node.get_label() == std::ssize(goal_sequence)) {
-            return top_node.get_path();
+        // Goal test, the agent must be able to stay in the last goal after the end of the path
+        if (top_node.get_label() == std::ssize(goal_sequence)
+            && top_node.get_location() == goal_sequence.back()
+            && constraint_table.can_stay(top_node.get_location(), top_node.get_g_value())) {
+            return pool.path(top_node);
         }
-        // Remember that we visited this location
-        explored.insert(top_node);
+        // Remember that we visited this state, skipping it if it was already expanded
+        if (!explored.insert(top_state)) continue;
+        const int top_index{pool.add(top_node)};
         // Populate frontier
-        for (const auto& child : top_node.get_children(map_instance)) {
+        for (const auto& child : top_node.get_children(map_instance, top_index)) {
             // Check if child is constrained
-            if (!is_constrained(constraints, agent, child, top_node)) {
-                if (!explored.contains(child) && !frontier.contains(child)) {
-                    frontier.push(child);
-                } else if (auto costly_child_opt
-                           = frontier.contains_more_expensive(child, child.get_f_value())) {
-                    frontier.replace(costly_child_opt.value(), child);
+            if (!constraint_table.is_constrained(
+                    child.get_g_value(), top_node.get_location(), child.get_location())) {
+                // the frontier and the explored set are keyed on the same state
+                const auto child_state{state(child)};
+                if (!explored.contains(child_state) && !frontier.contains(child_state)) {
+                    frontier.push(child, child_state);
+                } else {
+                    frontier.decrease_key(child, child_state);
                 }
             }
         }
@@ -111,4 +115,16 @@ path_t multi_a_star(int agent,
     throw std::runtime_error("[multiastar] No solution  for agent " + std::to_string(agent));
 }
 
+path_t find_path(Planner planner,
+                 int agent,
+                 Point start_location,
+                 const path_t& goal_sequence,
+                 const AmbientMapInstance& map_instance,
+                 const std::vector<Constraint>& constraints) {
+    if (planner == Planner::SIPP) {
+        return sipp(agent, start_location, goal_sequence, map_instance, constraints);
+    }
+    return multi_a_star(agent, start_location, goal_sequence, map_instance, constraints);
+}
+
 }  // namespace cmapd::multi_a_star
\ No newline at end of file
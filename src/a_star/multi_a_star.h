@@ -10,6 +10,7 @@
 #pragma once
 #include "Constraint.h"
 #include "Point.h"
+#include "a_star/Planner.h"
 #include "ambient/AmbientMapInstance.h"
 #include "custom_types.h"
 
@@ -37,4 +38,25 @@ path_t multi_a_star(int agent,
                     const std::vector<Constraint>& constraints = {},
                     int timeout = 0);
 
+/**
+ * Computes the shortest path from the start_location to all goals specified in goal_sequence,
+ * with the chosen planner.
+ * @param planner The algorithm used to find the path.
+ * @param agent The integer representing the agent for which we are computing the path.
+ * @param start_location The start location of the agent.
+ * @param goal_sequence The sequence of goals to be visited.
+ * @param map_instance The AmbientMapInstance on which the agents are moving.
+ * @param constraints A vector of constraints to be respected when computing the path.
+ * @return A vector of Point representing the found path.
+ * @throws runtime_error if no path is found or timeout is reached.
+ * @see multi_a_star
+ * @see sipp
+ */
+path_t find_path(Planner planner,
+                 int agent,
+                 Point start_location,
+                 const path_t& goal_sequence,
+                 const AmbientMapInstance& map_instance,
+                 const std::vector<Constraint>& constraints);
+
 }  // namespace cmapd::multi_a_star
\ No newline at end of file
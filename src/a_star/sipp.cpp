@@ -0,0 +1,210 @@
+/**
+ * @file
+ * @brief Contains the implementation of sipp.
+ * @author Jacopo Zagoli
+ * @version 1.0
+ * @date November, 2022
+ * @copyright 2022 Jacopo Zagoli, Davide Furlani
+ */
+
+#include "a_star/sipp.h"
+
+#include <algorithm>
+#include <iterator>
+#include <queue>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "Constraint.h"
+#include "Point.h"
+#include "a_star/ConstraintTable.h"
+#include "a_star/GoalSequence.h"
+#include "a_star/StateSet.h"
+#include "custom_types.h"
+
+namespace cmapd::multi_a_star {
+
+/**
+ * @struct IntervalNode
+ * @brief A node of the sipp search: the earliest arrival of the agent in a safe interval of a
+ * cell, having visited some goals.
+ */
+struct IntervalNode {
+    /// The value of parent for the root.
+    static constexpr int no_parent{-1};
+    /// The cell.
+    Point location;
+    /// The index of the safe interval among the ones of the cell.
+    int interval;
+    /// The timestep of the arrival in the cell, which is the g-value.
+    int arrival;
+    /// The h-value.
+    int h_value;
+    /// The number of goals already visited.
+    int label;
+    /// The index of the parent in the generated nodes, or no_parent.
+    int parent;
+};
+
+/**
+ * Reconstruct the positions from the root to a node, waiting in every cell until the arrival in
+ * the following one.
+ * @param nodes The generated nodes.
+ * @param index The index of the last node.
+ * @return A vector of Points.
+ */
+path_t interval_path(const std::vector<IntervalNode>& nodes, int index) {
+    path_t path(nodes[index].arrival + 1, nodes[index].location);
+    int departure{static_cast<int>(path.size())};
+    for (; index != IntervalNode::no_parent; index = nodes[index].parent) {
+        std::fill(path.begin() + nodes[index].arrival,
+                  path.begin() + departure,
+                  nodes[index].location);
+        departure = nodes[index].arrival;
+    }
+    return path;
+}
+
+path_t sipp(int agent,
+            Point start_location,
+            const path_t& goal_sequence,
+            const AmbientMapInstance& map_instance,
+            const std::vector<Constraint>& constraints,
+            int timeout) {
+    // compute timeout value
+    if (timeout == 0) {
+        timeout = map_instance.rows_number() * map_instance.columns_number() * 10;
+    }
+    // if the goal sequence is empty, the path is the starting point
+    if (goal_sequence.empty()) {
+        return path_t{start_location};
+    }
+    const ConstraintTable constraint_table{constraints, agent, map_instance};
+    // there are less safe intervals in a cell than constrained timesteps
+    if (constraint_table.last_timestep() >= any_timestep
+        || std::ssize(goal_sequence) > max_state_label) {
+        throw std::overflow_error("[sipp] The search states can't be packed in 64 bits.");
+    }
+    // the safe intervals are computed only for the reached cells
+    std::unordered_map<int, std::vector<SafeInterval>> intervals;
+    const auto safe_intervals = [&](Point cell) -> const std::vector<SafeInterval>& {
+        auto it{intervals.find(map_instance.cell_index(cell))};
+        if (it == intervals.end()) {
+            it = intervals
+                     .emplace(map_instance.cell_index(cell),
+                              constraint_table.safe_intervals(cell))
+                     .first;
+        }
+        return it->second;
+    };
+    // the state of a node, including the goal in its location as already visited
+    const auto state = [&](const IntervalNode& node) {
+        int label{node.label};
+        if (label < std::ssize(goal_sequence) && node.location == goal_sequence[label]) {
+            ++label;
+        }
+        return pack_state(map_instance.cell_index(node.location), node.interval, label);
+    };
+    // the generated nodes, the frontier and the explored set refer to them by index
+    std::vector<IntervalNode> nodes;
+    const auto comes_after = [&nodes](int lhs, int rhs) {
+        const int lhs_f{nodes[lhs].arrival + nodes[lhs].h_value};
+        const int rhs_f{nodes[rhs].arrival + nodes[rhs].h_value};
+        if (lhs_f != rhs_f) return lhs_f > rhs_f;
+        return nodes[lhs].h_value > nodes[rhs].h_value;
+    };
+    std::priority_queue<int, std::vector<int>, decltype(comes_after)> frontier{comes_after};
+    StateSet explored;
+    // the distances between goals are computed once for all the nodes
+    const GoalSequence goals{map_instance.h_table(), goal_sequence};
+    // generation of root node in the frontier
+    if (safe_intervals(start_location).empty()) {
+        throw std::runtime_error("[sipp] No solution for agent " + std::to_string(agent));
+    }
+    nodes.push_back({.location = start_location,
+                     .interval = 0,
+                     .arrival = 0,
+                     .h_value = goals.h_value(start_location, 0),
+                     .label = 0,
+                     .parent = IntervalNode::no_parent});
+    frontier.push(0);
+
+    // main loop
+    while (!frontier.empty()) {
+        // timeout operations
+        if (timeout <= 0) {
+            throw std::runtime_error("[sipp] Timeout! For agent " + std::to_string(agent));
+        } else {
+            --timeout;
+        }
+        // get top node
+        const int top_index{frontier.top()};
+        frontier.pop();
+        const auto top_state{state(nodes[top_index])};
+        IntervalNode top_node{nodes[top_index]};
+        // Update label
+        if (top_node.label < std::ssize(goal_sequence)
+            && top_node.location == goal_sequence[top_node.label]) {
+            ++top_node.label;
+        }
+        // Goal test, the agent must be able to stay in the last goal after the end of the path
+        if (top_node.label == std::ssize(goal_sequence) && top_node.location == goal_sequence.back()
+            && constraint_table.can_stay(top_node.location, top_node.arrival)) {
+            return interval_path(nodes, top_index);
+        }
+        // Remember that we visited this state, skipping it if it was already expanded
+        if (!explored.insert(top_state)) continue;
+        const SafeInterval interval{safe_intervals(top_node.location)[top_node.interval]};
+        // the agent can leave the cell until the end of the interval
+        const int last_arrival{interval.end == SafeInterval::forever ? SafeInterval::forever
+                                                                     : interval.end + 1};
+        const auto push = [&](Point location, int interval_index, int arrival) {
+            IntervalNode child{.location = location,
+                               .interval = interval_index,
+                               .arrival = arrival,
+                               .h_value = goals.h_value(location, top_node.label),
+                               .label = top_node.label,
+                               .parent = top_index};
+            if (!explored.contains(state(child))) {
+                nodes.push_back(child);
+                frontier.push(static_cast<int>(nodes.size()) - 1);
+            }
+        };
+        // Populate frontier
+        for (const int cell : map_instance.neighbours(top_node.location)) {
+            const Point location{map_instance.cell_point(cell)};
+            if (location == top_node.location) {
+                // a single wait, needed only to visit the same goal twice in a row
+                if (top_node.arrival < interval.end) {
+                    push(location, top_node.interval, top_node.arrival + 1);
+                }
+                continue;
+            }
+            const auto& child_intervals{safe_intervals(location)};
+            for (int index = 0; index < std::ssize(child_intervals); ++index) {
+                const SafeInterval& child_interval{child_intervals[index]};
+                if (child_interval.begin > last_arrival) break;
+                if (child_interval.end <= top_node.arrival) continue;
+                // the earliest arrival in the interval, with a move that isn't constrained
+                const int latest{std::min(last_arrival, child_interval.end)};
+                int arrival{std::max(top_node.arrival + 1, child_interval.begin)};
+                while (arrival <= latest
+                       && constraint_table.is_constrained(arrival, top_node.location, location)) {
+                    // after the last constrained timestep, the move is always constrained
+                    if (arrival > constraint_table.last_timestep()) break;
+                    ++arrival;
+                }
+                if (arrival <= latest
+                    && !constraint_table.is_constrained(arrival, top_node.location, location)) {
+                    push(location, index, arrival);
+                }
+            }
+        }
+    }
+    // No solution is found
+    throw std::runtime_error("[sipp] No solution for agent " + std::to_string(agent));
+}
+
+}  // namespace cmapd::multi_a_star
@@ -0,0 +1,42 @@
+/**
+ * @file
+ * @brief declaration of sipp function.
+ * @author Jacopo Zagoli
+ * @version 1.0
+ * @date November, 2022
+ * @copyright 2022 Jacopo Zagoli, Davide Furlani
+ */
+
+#pragma once
+#include <vector>
+
+#include "Constraint.h"
+#include "Point.h"
+#include "ambient/AmbientMapInstance.h"
+#include "custom_types.h"
+
+namespace cmapd::multi_a_star {
+
+/**
+ * Computes the shortest path from the start_location to all goals specified in goal_sequence,
+ * respecting their order in the vector, like multi_a_star. The search states are the safe
+ * intervals of the cells instead of the timesteps, so a long wait is a single step of the search.
+ * @param agent The integer representing the agent for which we are computing the path.
+ * @param start_location The start location of the agent.
+ * @param goal_sequence The sequence of goals to be visited.
+ * @param map_instance The AmbientMapInstance on which the agents are moving.
+ * @param constraints A vector of constraints to be respected when computing the path.
+ * @param timeout A upper limit on the number of iterations. If zero, is automatically computed.
+ * @return A vector of Point representing the found path.
+ * @throws runtime_error if no path is found or timeout is reached.
+ * @see SIPP: Safe Interval Path Planning for Dynamic Environments.
+ * @see Lifelong Multi-Agent Path Finding in Large-Scale Warehouses.
+ */
+path_t sipp(int agent,
+            Point start_location,
+            const path_t& goal_sequence,
+            const AmbientMapInstance& map_instance,
+            const std::vector<Constraint>& constraints = {},
+            int timeout = 0);
+
+}  // namespace cmapd::multi_a_star
@@ -11,11 +11,17 @@
 
 #include <fmt/format.h>
 
+#include <charconv>
 #include <filesystem>
-#include <fstream>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <string_view>
 #include <vector>
 
 #include "Point.h"
+#include "ambient/MappedFile.h"
+#include "custom_types.h"
 
 namespace cmapd {
 
@@ -32,56 +38,152 @@ void validate_char(char c, int row, int col) {
     }
 }
 
+/**
+ * Converts a char of a MovingAI map to the one of a map: the passable terrains ('.', 'G', 'S')
+ * become possible generation positions, while out of bounds cells, trees and water are walls.
+ * @param c The char to be converted.
+ * @param row The row of the char.
+ * @param col The column of the char.
+ * @return the converted char.
+ */
+char convert_moving_ai_char(char c, int row, int col) {
+    switch (c) {
+        case '.':
+        case 'G':
+        case 'S':
+            return 'O';
+        case '@':
+        case 'O':
+        case 'T':
+        case 'W':
+            return '#';
+        default:
+            throw std::runtime_error{
+                fmt::format("character {} in line {}:{} is not a valid character", c, row, col)};
+    }
+}
+
+/**
+ * Reads the value of a line of the header of a MovingAI map, like "height 32".
+ * @param text The map, starting from the line.
+ * @param key The expected key of the line.
+ * @return the value.
+ */
+std::string_view moving_ai_header(std::string_view& text, std::string_view key) {
+    std::string_view line{next_line(text)};
+    if (next_token(line) != key) {
+        throw std::runtime_error{fmt::format("the MovingAI map header has no {} line", key)};
+    }
+    return next_token(line);
+}
+
 AmbientMap::AmbientMap(const std::filesystem::path& path_to_map) {
-    
-    std::ifstream map_file{path_to_map};
-    if (!map_file) {
-        throw std::runtime_error{fmt::format("{}: file does non exist", path_to_map.string())};
+    const MappedFile map_file{path_to_map};
+    std::string_view text{map_file.contents()};
+    // MovingAI maps start with "type octile", while maps can't contain a 't'
+    const bool moving_ai{text.starts_with("type")};
+    int expected_rows{-1};
+    if (moving_ai) {
+        moving_ai_header(text, "type");
+        const auto height{moving_ai_header(text, "height")};
+        const auto width{moving_ai_header(text, "width")};
+        if (next_line(text) != "map"
+            || std::from_chars(height.data(), height.data() + height.size(), expected_rows).ec
+                   != std::errc{}
+            || std::from_chars(width.data(), width.data() + width.size(), m_columns).ec
+                   != std::errc{}
+            || expected_rows <= 0 || m_columns <= 0
+            || m_columns > std::numeric_limits<int>::max() - 2) {
+            throw std::runtime_error{
+                fmt::format("{}: malformed MovingAI map header", path_to_map.string())};
+        }
+    }
+    if (text.empty() || text.front() == '\n' || text.front() == '\r') {
+        throw std::runtime_error{fmt::format("{}: the map is empty", path_to_map.string())};
     }
-    
-    std::string line {};
-    int rows_counter {0};
-    while(std::getline(map_file, line)){
-        std::vector<char> char_vec {};
-        int cols_counter {0};
-        for(char c : line){
-            validate_char(c, rows_counter, cols_counter);
-            char_vec.push_back(c);
-            cols_counter++;
+
+    // the grid is built row by row, with the border of walls, while the file is read
+    if (!moving_ai) {
+        std::string_view first_line{text};
+        first_line = next_line(first_line);
+        if (first_line.size() > std::numeric_limits<int>::max() - 2) {
+            throw std::overflow_error("The number of rows or columns is larger than a int.");
         }
-        rows_counter++;
-        AmbientMap::m_grid.emplace_back(char_vec);
+        m_columns = static_cast<int>(first_line.size());
     }
+    m_grid.reserve(text.size() + 4 * static_cast<std::size_t>(m_columns));
+    m_grid.assign(m_columns + 2, '#');
+    while (!text.empty()) {
+        const std::string_view line{next_line(text)};
+        if (std::ssize(line) != m_columns) {
+            throw std::runtime_error{fmt::format(
+                "line {} has {} columns instead of {}", m_rows, line.size(), m_columns)};
+        }
+        if (m_rows == std::numeric_limits<int>::max() - 2) {
+            throw std::overflow_error("The number of rows or columns is larger than a int.");
+        }
+        m_grid.push_back('#');
+        for (int col = 0; col < m_columns; ++col) {
+            if (moving_ai) {
+                m_grid.push_back(convert_moving_ai_char(line[col], m_rows, col));
+            } else {
+                validate_char(line[col], m_rows, col);
+                m_grid.push_back(line[col]);
+            }
+        }
+        m_grid.push_back('#');
+        ++m_rows;
+    }
+    m_grid.insert(m_grid.end(), m_columns + 2, '#');
+    if (moving_ai && m_rows != expected_rows) {
+        throw std::runtime_error{fmt::format(
+            "{}: the map has {} rows instead of {}", path_to_map.string(), m_rows, expected_rows)};
+    }
+    build_neighbours();
 }
 
-const std::vector<std::vector<char>>& AmbientMap::map() const { return AmbientMap::m_grid; }
-
-int AmbientMap::rows_number() const {
-    if (m_grid.size() > std::numeric_limits<int>::max())
-        throw std::overflow_error("The number of rows is larger than a int.");
-    return static_cast<int>(m_grid.size());
+void AmbientMap::build_neighbours() {
+    m_neighbour_offsets.assign(static_cast<std::size_t>(m_rows) * m_columns + 1, 0);
+    m_neighbours.clear();
+    for (int row = 0; row < m_rows; ++row) {
+        for (int col = 0; col < m_columns; ++col) {
+            const Point point{row, col};
+            if (is_passable(point)) {
+                for (moves_t moves{{0, 0}, {0, 1}, {1, 0}, {0, -1}, {-1, 0}};
+                     const auto& move : moves) {
+                    if (is_passable(point + move)) m_neighbours.push_back(cell_index(point + move));
+                }
+            }
+            m_neighbour_offsets[cell_index(point) + 1] = static_cast<int>(m_neighbours.size());
+        }
+    }
 }
 
-int AmbientMap::columns_number() const {
-    if (m_grid[0].size() > std::numeric_limits<int>::max())
-        throw std::overflow_error("The number of columns is larger than a int.");
-    return static_cast<int>(m_grid[0].size());
+std::vector<std::vector<char>> AmbientMap::to_rows() const {
+    std::vector<std::vector<char>> rows(m_rows, std::vector<char>(m_columns));
+    for (int row = 0; row < m_rows; ++row) {
+        for (int col = 0; col < m_columns; ++col) {
+            rows[row][col] = grid_cell({row, col});
+        }
+    }
+    return rows;
 }
 
+int AmbientMap::rows_number() const { return m_rows; }
+
+int AmbientMap::columns_number() const { return m_columns; }
+
 bool AmbientMap::is_inside(Point p) const {
-    return p.row >= 0 && p.row < this->rows_number() && p.col >= 0
-           && p.col < this->columns_number();
+    return p.row >= 0 && p.row < m_rows && p.col >= 0 && p.col < m_columns;
 }
 
-bool AmbientMap::is_valid(Point p) const {
-    return this->is_inside(p) && m_grid[p.row][p.col] == 'O';
-}
+bool AmbientMap::is_valid(Point p) const { return is_inside(p) && grid_cell(p) == 'O'; }
 
 std::string AmbientMap::to_string() const {
     std::string s;
-    for (const auto& row : AmbientMap::m_grid) {
-        for (char c : row) {
-            s += c;
+    for (int row = 0; row < m_rows; ++row) {
+        for (int col = 0; col < m_columns; ++col) {
+            s += grid_cell({row, col});
         }
         s += "\n";
     }
@@ -7,8 +7,10 @@
  * @copyright 2022 Jacopo Zagoli, Davide Furlani
  */
 #pragma once
+#include <cstddef>
 #include <filesystem>
 #include <ostream>
+#include <span>
 #include <string>
 #include <vector>
 
@@ -21,25 +23,55 @@ namespace cmapd {
  */
 class AmbientMap {
   protected:
+    /// The number of rows of the map.
+    int m_rows{0};
+    /// The number of columns of the map.
+    int m_columns{0};
     /**
-     * The parsed map
+     * The parsed map, row by row, surrounded by a border of walls ('#'), so that the neighbours of
+     * a cell inside the map are never outside the grid.
      */
-    std::vector<std::vector<char>> m_grid;
+    std::vector<char> m_grid;
+    /**
+     * For every cell, the position in m_neighbours of its first neighbour. The neighbours of the
+     * cell c are the ones between m_neighbour_offsets[c] and m_neighbour_offsets[c + 1].
+     */
+    std::vector<int> m_neighbour_offsets;
+    /// The neighbours of all the cells, in compressed sparse row format.
+    std::vector<int> m_neighbours;
+
+    /// Computes the neighbours of every cell from the grid.
+    void build_neighbours();
+
+    /**
+     * Get a cell of the parsed map.
+     * @param p A point inside the map.
+     * @return a reference to the char of p.
+     */
+    [[nodiscard]] char& grid_cell(Point p);
+    /**
+     * Get a cell of the parsed map.
+     * @param p A point inside the map.
+     * @return the char of p.
+     */
+    [[nodiscard]] char grid_cell(Point p) const;
 
   public:
     /**
      * Constructor of ambient map: take a path to file containing 2 integers representing number of
      * rows and columns of the map and the overall structure of the map ('#' for walls, ' ' for
-     * empty spaces, 'O' for possible agent and targets positions)
+     * empty spaces, 'O' for possible agent and targets positions). MovingAI maps (.map) are
+     * accepted too, and their passable cells become possible agent and targets positions.
      * @param path_to_map
-     * @throw runtime_error if the file in input does not exist
+     * @throw runtime_error if the file in input does not exist or is malformed
      */
     explicit AmbientMap(const std::filesystem::path& path_to_map);
     /**
-     * Method that returns a const reference of the map structure
-     * @return const reference of the map structure
+     * Converts the map structure to a grid of chars, row by row. The grid is built at every call,
+     * use is_passable and is_valid to read single cells.
+     * @return the map structure
      */
-    [[nodiscard]] const std::vector<std::vector<char>>& map() const;
+    [[nodiscard]] std::vector<std::vector<char>> to_rows() const;
     /**
      * Method that return an int representing the number of rows of the map
      * @return the number of rows of the map
@@ -62,12 +94,44 @@ class AmbientMap {
      * @return true if the given Point is a possible generation position inside the map, false
      * otherwise
      */
-    [[nodiscard]] virtual bool is_valid(Point p) const;
+    [[nodiscard]] bool is_valid(Point p) const;
+    /**
+     * Checks if a position isn't a wall, without bounds checks. Used by the search algorithms.
+     * @param p A point inside the map, or one step outside of it.
+     * @return true if the given Point is inside the map and it's not a wall, false otherwise
+     */
+    [[nodiscard]] bool is_passable(Point p) const;
+    /**
+     * Get the index of a cell, that is row * columns + column.
+     * @param p A point inside the map.
+     * @return the cell index of p.
+     */
+    [[nodiscard]] int cell_index(Point p) const;
+    /**
+     * Get the point of a cell.
+     * @param cell A cell index.
+     * @return the point whose cell index is cell.
+     */
+    [[nodiscard]] Point cell_point(int cell) const;
+    /**
+     * Get the cells which can be reached from a cell in one move, including the cell itself
+     * (the wait move) first. Walls have no neighbours.
+     * @param cell A cell index.
+     * @return the cell indexes of the neighbours.
+     */
+    [[nodiscard]] std::span<const int> neighbours(int cell) const;
+    /**
+     * Get the cells which can be reached from a point in one move, including the point itself
+     * (the wait move) first. Walls have no neighbours.
+     * @param p A point inside the map.
+     * @return the cell indexes of the neighbours.
+     */
+    [[nodiscard]] std::span<const int> neighbours(Point p) const;
     /**
      * Method that return a string representing the structure of the map
      * @return a string representing the structure of the map
      */
-    [[nodiscard]] virtual std::string to_string() const;
+    [[nodiscard]] std::string to_string() const;
     /**
      * Stream operator
      * @param os output stream
@@ -77,4 +141,27 @@ class AmbientMap {
     friend std::ostream& operator<<(std::ostream& os, const AmbientMap& map);
 };
 
+inline char& AmbientMap::grid_cell(Point p) {
+    return m_grid[static_cast<std::size_t>(p.row + 1) * (m_columns + 2) + p.col + 1];
+}
+
+inline char AmbientMap::grid_cell(Point p) const {
+    return m_grid[static_cast<std::size_t>(p.row + 1) * (m_columns + 2) + p.col + 1];
+}
+
+inline bool AmbientMap::is_passable(Point p) const { return grid_cell(p) != '#'; }
+
+inline int AmbientMap::cell_index(Point p) const { return p.row * m_columns + p.col; }
+
+inline Point AmbientMap::cell_point(int cell) const { return {cell / m_columns, cell % m_columns}; }
+
+inline std::span<const int> AmbientMap::neighbours(int cell) const {
+    return {m_neighbours.data() + m_neighbour_offsets[cell],
+            static_cast<std::size_t>(m_neighbour_offsets[cell + 1] - m_neighbour_offsets[cell])};
+}
+
+inline std::span<const int> AmbientMap::neighbours(Point p) const {
+    return neighbours(cell_index(p));
+}
+
 }  // namespace cmapd
@@ -11,75 +11,51 @@
 
 #include <fmt/format.h>
 
+#include <algorithm>
+#include <cstddef>
 #include <filesystem>
-#include <fstream>
+#include <memory>
+#include <string>
+#include <utility>
 #include <vector>
 
 #include "Point.h"
+#include "ambient/instance_io.h"
 #include "distances/distances.h"
 
 namespace cmapd {
 
 AmbientMapInstance::AmbientMapInstance(const std::filesystem::path& path_to_map_instance,
-                                       const std::filesystem::path& path_to_map)
-    : AmbientMap(path_to_map) {
-    std::ifstream map_instance_file{path_to_map_instance};
-    if (!map_instance_file) {
-        throw std::runtime_error{
-            fmt::format("{}: file does non exist", path_to_map_instance.string())};
-    }
-
-    int num_agents{0};
-    int num_tasks{0};
-
-    map_instance_file >> num_agents;
-    map_instance_file >> num_tasks;
-
-    for (int i = 0; i < num_agents; i++) {
-        int row_pos{0};
-        int col_pos{0};
-        map_instance_file >> row_pos;
-        map_instance_file >> col_pos;
-        m_grid[row_pos][col_pos] = 'a';
-        m_agents.emplace_back(row_pos, col_pos);
-    }
-
-    for (int i = 0; i < num_tasks; i++) {
-        int row_pos_start{0};
-        int col_pos_start{0};
-        int row_pos_goal{0};
-        int col_pos_goal{0};
-        map_instance_file >> row_pos_start;
-        map_instance_file >> col_pos_start;
-        m_grid[row_pos_start][col_pos_start] = 't';
-        map_instance_file >> row_pos_goal;
-        map_instance_file >> col_pos_goal;
-        m_grid[row_pos_goal][col_pos_goal] = 't';
-        m_tasks.emplace_back(Point{row_pos_start, col_pos_start},
-                             Point{row_pos_goal, col_pos_goal});
-    }
+                                       const std::filesystem::path& path_to_map,
+                                       const DistancesConfig& config)
+    : AmbientMapInstance(
+        std::make_shared<const AmbientMap>(path_to_map), path_to_map_instance, config) {}
+
+AmbientMapInstance::AmbientMapInstance(std::shared_ptr<const AmbientMap> map,
+                                       const std::filesystem::path& path_to_map_instance,
+                                       const DistancesConfig& config)
+    : m_map{std::move(map)} {
+    auto [agents, tasks] = load_instance(path_to_map_instance, *m_map);
+    m_agents = std::move(agents);
+    m_tasks = std::move(tasks);
+    m_h_table = compute_h_table(*this, config);
+}
 
-    m_h_table = compute_h_table(*this);
+AmbientMapInstance::AmbientMapInstance(std::shared_ptr<const AmbientMap> map,
+                                       std::vector<Point> a,
+                                       std::vector<std::pair<Point, Point>> t,
+                                       const DistancesConfig& config)
+    : m_map{std::move(map)},
+      m_agents{std::move(a)},
+      m_tasks{std::move(t)} {
+    m_h_table = compute_h_table(*this, config);
 }
 
 AmbientMapInstance::AmbientMapInstance(const AmbientMap& map,
                                        const std::vector<Point>& a,
-                                       const std::vector<std::pair<Point, Point>>& t)
-    : AmbientMap(map) {
-    m_agents = a;
-    m_tasks = t;
-
-    for (auto agent : m_agents) {
-        m_grid[agent.row][agent.col] = 'a';
-    }
-
-    for (auto task : m_tasks) {
-        m_grid[task.first.row][task.first.col] = 't';
-        m_grid[task.second.row][task.second.col] = 't';
-    }
-
-    m_h_table = compute_h_table(*this);
-}
+                                       const std::vector<std::pair<Point, Point>>& t,
+                                       const DistancesConfig& config)
+    : AmbientMapInstance(std::make_shared<const AmbientMap>(map), a, t, config) {}
 
 int AmbientMapInstance::num_agents() const {
     if (m_agents.size() > std::numeric_limits<int>::max())
@@ -93,21 +69,21 @@ int AmbientMapInstance::num_tasks() const {
     return static_cast<int>(m_tasks.size());
 }
 
-bool AmbientMapInstance::is_valid(Point p) const {
-    return p.row >= 0 && p.row < this->rows_number() && p.col >= 0 && p.col < this->columns_number()
-           && m_grid[p.row][p.col] != '#';
-}
+bool AmbientMapInstance::is_valid(Point p) const { return is_inside(p) && is_passable(p); }
 
 std::string AmbientMapInstance::to_string() const {
-    std::string s;
-    for (int r = 0; r < this->rows_number(); r++) {
-        for (int c = 0; c < this->columns_number(); c++) {
-            if (m_grid[r][c] == 'O')
-                s += ' ';
-            else
-                s += m_grid[r][c];
-        }
-        s += "\n";
+    std::string s{m_map->to_string()};
+    std::replace(s.begin(), s.end(), 'O', ' ');
+    // every row is followed by a newline
+    const auto position = [this](Point p) {
+        return static_cast<std::size_t>(p.row) * (columns_number() + 1) + p.col;
+    };
+    for (auto agent : m_agents) {
+        s[position(agent)] = 'a';
+    }
+    for (auto task : m_tasks) {
+        s[position(task.first)] = 't';
+        s[position(task.second)] = 't';
     }
     return s;
 }
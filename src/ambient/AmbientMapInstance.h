@@ -9,7 +9,9 @@
 
 #pragma once
 #include <filesystem>
+#include <memory>
 #include <ostream>
+#include <span>
 #include <string>
 #include <utility>
 #include <vector>
@@ -17,15 +19,18 @@
 #include "Point.h"
 #include "ambient/AmbientMap.h"
 #include "custom_types.h"
+#include "distances/DistancesConfig.h"
 
 namespace cmapd {
 /**
  * @class AmbientMapInstance
- * @brief This class extends AmbientMap with the initial position of agents and tasks, and
- * with a distance matrix.
+ * @brief This class represents the initial position of agents and tasks on a map, with a distance
+ * matrix. The map is immutable and shared by all the instances on it, so the memory used by an
+ * instance (besides the distance matrix) depends only on its agents and tasks.
  */
-class AmbientMapInstance final : public AmbientMap {
+class AmbientMapInstance final {
   private:
+    std::shared_ptr<const AmbientMap> m_map;
     std::vector<Point> m_agents;
     std::vector<std::pair<Point, Point>> m_tasks;
     h_table_t m_h_table;
@@ -34,19 +39,54 @@ class AmbientMapInstance final : public AmbientMap {
     /**
      * Constructor of an already generated ambient map instance: takes two paths, one to
      * auto-generated file containing the instance info and the other to the map file use to
-     * generate the previous one
-     * @throw runtime_error if any of the required files do not exist
+     * generate the previous one. The instance can also be a binary instance or a MovingAI
+     * scenario (.scen), and the map a MovingAI map (.map).
+     * @param config The options used to compute the h-table.
+     * @throw runtime_error if any of the required files do not exist or are malformed
      */
     explicit AmbientMapInstance(const std::filesystem::path& path_to_map_instance,
-                                const std::filesystem::path& path_to_map);
+                                const std::filesystem::path& path_to_map,
+                                const DistancesConfig& config = {});
+    /**
+     * Constructor of an already generated ambient map instance, on a map already loaded.
+     * @param map The map of the instance, shared with the other instances.
+     * @param path_to_map_instance The instance file, in any of the formats read by load_instance.
+     * @param config The options used to compute the h-table.
+     * @throw runtime_error if the file does not exist or is malformed
+     */
+    explicit AmbientMapInstance(std::shared_ptr<const AmbientMap> map,
+                                const std::filesystem::path& path_to_map_instance,
+                                const DistancesConfig& config = {});
     /**
      * Constructor of ambient map instance: takes a map, a reference to a vector of agents
      * [std::vector<Point>] and a reference to a vector of tasks [std::vector<std::pair<Point,
      * Point>>]
+     * @param map The map of the instance, shared with the other instances.
+     * @param config The options used to compute the h-table.
+     */
+    explicit AmbientMapInstance(std::shared_ptr<const AmbientMap> map,
+                                std::vector<Point> a,
+                                std::vector<std::pair<Point, Point>> t,
+                                const DistancesConfig& config = {});
+    /**
+     * Constructor of ambient map instance on a copy of a map, see the constructor above.
+     * @param config The options used to compute the h-table.
      */
     explicit AmbientMapInstance(const AmbientMap& map,
                                 const std::vector<Point>& a,
-                                const std::vector<std::pair<Point, Point>>& t);
+                                const std::vector<std::pair<Point, Point>>& t,
+                                const DistancesConfig& config = {});
+    /**
+     * Method that returns the map of the instance
+     * @returns the map, without agents and tasks
+     */
+    [[nodiscard]] const AmbientMap& ambient_map() const;
+    /**
+     * Get the map of the instance, shared with the other instances and with the h-tables that
+     * search it.
+     * @returns the pointer to the map
+     */
+    [[nodiscard]] const std::shared_ptr<const AmbientMap>& shared_ambient_map() const;
     /**
      * Method that return the number of agents in the map
      * @returns the number of agents in the map
@@ -57,17 +97,34 @@ class AmbientMapInstance final : public AmbientMap {
      * @returns the number of tasks in the map
      */
     [[nodiscard]] int num_tasks() const;
+    /// @copydoc AmbientMap::rows_number()
+    [[nodiscard]] int rows_number() const;
+    /// @copydoc AmbientMap::columns_number()
+    [[nodiscard]] int columns_number() const;
+    /// @copydoc AmbientMap::is_inside()
+    [[nodiscard]] bool is_inside(Point p) const;
     /**
      * Checks if a position can be a valid move position in the map
      * @param[in] p The point to check
      * @returns True if the given Point is inside the map and it's not a wall, false otherwise
      */
-    [[nodiscard]] bool is_valid(Point p) const override;
+    [[nodiscard]] bool is_valid(Point p) const;
+    /// @copydoc AmbientMap::is_passable()
+    [[nodiscard]] bool is_passable(Point p) const;
+    /// @copydoc AmbientMap::cell_index()
+    [[nodiscard]] int cell_index(Point p) const;
+    /// @copydoc AmbientMap::cell_point()
+    [[nodiscard]] Point cell_point(int cell) const;
+    /// @copydoc AmbientMap::neighbours(int) const
+    [[nodiscard]] std::span<const int> neighbours(int cell) const;
+    /// @copydoc AmbientMap::neighbours(Point) const
+    [[nodiscard]] std::span<const int> neighbours(Point p) const;
     /**
-     * Method that return a string representing the structure of the map
+     * Method that return a string representing the structure of the map, with 'a' for agents
+     * and 't' for the starts and goals of tasks
      * @returns a string representing the structure of the map
      */
-    [[nodiscard]] std::string to_string() const override;
+    [[nodiscard]] std::string to_string() const;
     /**
      * Method that return the list of tasks of the instance
      * @returns the list of tasks of the instance
@@ -91,5 +148,31 @@ class AmbientMapInstance final : public AmbientMap {
      */
     friend std::ostream& operator<<(std::ostream& os, const AmbientMapInstance& instance);
 };
-}  // namespace cmapd
 
+inline const AmbientMap& AmbientMapInstance::ambient_map() const { return *m_map; }
+
+inline const std::shared_ptr<const AmbientMap>& AmbientMapInstance::shared_ambient_map() const {
+    return m_map;
+}
+
+inline int AmbientMapInstance::rows_number() const { return m_map->rows_number(); }
+
+inline int AmbientMapInstance::columns_number() const { return m_map->columns_number(); }
+
+inline bool AmbientMapInstance::is_inside(Point p) const { return m_map->is_inside(p); }
+
+inline bool AmbientMapInstance::is_passable(Point p) const { return m_map->is_passable(p); }
+
+inline int AmbientMapInstance::cell_index(Point p) const { return m_map->cell_index(p); }
+
+inline Point AmbientMapInstance::cell_point(int cell) const { return m_map->cell_point(cell); }
+
+inline std::span<const int> AmbientMapInstance::neighbours(int cell) const {
+    return m_map->neighbours(cell);
+}
+
+inline std::span<const int> AmbientMapInstance::neighbours(Point p) const {
+    return m_map->neighbours(p);
+}
+
+}  // namespace cmapd
@@ -0,0 +1,25 @@
+/**
+ * @file
+ * @brief Contains the InstanceFormat enum.
+ * @author Davide Furlani
+ * @version 1.0
+ * @date November, 2022
+ * @copyright 2022 Jacopo Zagoli, Davide Furlani
+ */
+
+#pragma once
+
+namespace cmapd {
+
+/**
+ * @enum InstanceFormat
+ * @brief Describes how an instance is saved to a file.
+ */
+enum class InstanceFormat {
+    /// The numbers are written as text, a row for every agent and task.
+    TEXT,
+    /// The numbers are written as 32 bits integers, see BinaryInstanceHeader.
+    BINARY
+};
+
+}  // namespace cmapd
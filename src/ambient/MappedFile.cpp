@@ -0,0 +1,91 @@
+/**
+ * @file
+ * @brief Contains the implementation of class MappedFile.
+ * @author Davide Furlani
+ * @version 1.0
+ * @date November, 2022
+ * @copyright 2022 Jacopo Zagoli, Davide Furlani
+ */
+
+#include "ambient/MappedFile.h"
+
+#include <fcntl.h>
+#include <fmt/format.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <charconv>
+#include <filesystem>
+#include <optional>
+#include <stdexcept>
+#include <string_view>
+
+namespace cmapd {
+
+MappedFile::MappedFile(const std::filesystem::path& path) {
+    const int fd{::open(path.c_str(), O_RDONLY)};
+    if (fd == -1) {
+        throw std::runtime_error{fmt::format("{}: file does non exist", path.string())};
+    }
+    struct stat file_stat {};
+    if (::fstat(fd, &file_stat) == -1 || !S_ISREG(file_stat.st_mode)) {
+        ::close(fd);
+        throw std::runtime_error{fmt::format("{}: not a regular file", path.string())};
+    }
+    m_size = static_cast<std::size_t>(file_stat.st_size);
+    if (m_size > 0) {
+        m_data = ::mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    }
+    ::close(fd);
+    if (m_data == MAP_FAILED) {
+        throw std::runtime_error{fmt::format("{}: can't map the file", path.string())};
+    }
+    if (m_data != nullptr) {
+        // the file is read once from the beginning to the end
+        ::madvise(m_data, m_size, MADV_SEQUENTIAL);
+    }
+}
+
+MappedFile::~MappedFile() {
+    if (m_data != nullptr) ::munmap(m_data, m_size);
+}
+
+std::string_view MappedFile::contents() const {
+    return m_data == nullptr ? std::string_view{}
+                             : std::string_view{static_cast<const char*>(m_data), m_size};
+}
+
+std::string_view next_line(std::string_view& text) {
+    const auto end{text.find('\n')};
+    std::string_view line{text.substr(0, end)};
+    text.remove_prefix(end == std::string_view::npos ? text.size() : end + 1);
+    if (line.ends_with('\r')) line.remove_suffix(1);
+    return line;
+}
+
+std::string_view next_token(std::string_view& text) {
+    constexpr std::string_view blanks{" \t\r\n"};
+    const auto begin{text.find_first_not_of(blanks)};
+    if (begin == std::string_view::npos) {
+        text = {};
+        return {};
+    }
+    text.remove_prefix(begin);
+    const auto end{text.find_first_of(blanks)};
+    std::string_view token{text.substr(0, end)};
+    text.remove_prefix(token.size());
+    return token;
+}
+
+std::optional<int> next_int(std::string_view& text) {
+    const std::string_view token{next_token(text)};
+    int value{0};
+    const auto [end, error] = std::from_chars(token.data(), token.data() + token.size(), value);
+    if (token.empty() || error != std::errc{} || end != token.data() + token.size()) {
+        return std::nullopt;
+    }
+    return value;
+}
+
+}  // namespace cmapd
@@ -0,0 +1,66 @@
+/**
+ * @file
+ * @brief Contains the class MappedFile.
+ * @author Davide Furlani
+ * @version 1.0
+ * @date November, 2022
+ * @copyright 2022 Jacopo Zagoli, Davide Furlani
+ */
+
+#pragma once
+#include <cstddef>
+#include <filesystem>
+#include <optional>
+#include <string_view>
+
+namespace cmapd {
+
+/**
+ * @class MappedFile
+ * @brief A read-only file mapped in memory, so that it can be parsed without copying it.
+ */
+class MappedFile {
+  private:
+    /// The first byte of the mapping, or nullptr if the file is empty.
+    void* m_data{nullptr};
+    /// The size of the file.
+    std::size_t m_size{0};
+
+  public:
+    /**
+     * Maps a file in memory.
+     * @param path The path to the file.
+     * @throw runtime_error if the file does not exist or can't be mapped.
+     */
+    explicit MappedFile(const std::filesystem::path& path);
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+    /// Unmaps the file.
+    ~MappedFile();
+    /**
+     * Get the contents of the file.
+     * @return a view over the contents, valid while the MappedFile exists.
+     */
+    [[nodiscard]] std::string_view contents() const;
+};
+
+/**
+ * Removes the first line from a text.
+ * @param text The text, which is left starting from the following line.
+ * @return the line, without the line terminator ("\n" or "\r\n").
+ */
+std::string_view next_line(std::string_view& text);
+/**
+ * Removes the first token, that is a sequence of non-blank chars, from a text.
+ * @param text The text, which is left starting right after the token.
+ * @return the token, or an empty view if the text is blank.
+ */
+std::string_view next_token(std::string_view& text);
+/**
+ * Removes the first token from a text and parses it as an integer.
+ * @param text The text, which is left starting right after the token.
+ * @return the integer, or nullopt if the token is not an integer.
+ */
+std::optional<int> next_int(std::string_view& text);
+
+}  // namespace cmapd
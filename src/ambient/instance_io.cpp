@@ -0,0 +1,316 @@
+/**
+ * @file
+ * @brief Contains the implementation of the functions saving instances and solutions.
+ * @author Davide Furlani
+ * @version 1.0
+ * @date November, 2022
+ * @copyright 2022 Jacopo Zagoli, Davide Furlani
+ */
+
+#include "ambient/instance_io.h"
+
+#include <fmt/format.h>
+
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "CmapdSolution.h"
+#include "Point.h"
+#include "ambient/AmbientMap.h"
+#include "ambient/InstanceFormat.h"
+#include "ambient/MappedFile.h"
+
+namespace cmapd {
+
+/**
+ * Writes some bytes to a file.
+ * @param path The path of the file, which is overwritten.
+ * @param data The first byte.
+ * @param size The number of bytes.
+ */
+void write_file(const std::filesystem::path& path, const void* data, std::size_t size) {
+    std::ofstream out_file{path, std::ios::binary | std::ios::trunc};
+    out_file.write(static_cast<const char*>(data), static_cast<std::streamsize>(size));
+    if (!out_file) {
+        throw std::runtime_error{fmt::format("{}: can't write the file", path.string())};
+    }
+}
+
+/**
+ * Checks that a position read from a file is a free cell of the map.
+ * @param map The map.
+ * @param p The position.
+ * @param path The path of the file, used in the error message.
+ * @return p.
+ * @throw runtime_error if p is outside the map or it's a wall.
+ */
+Point checked_point(const AmbientMap& map, Point p, const std::filesystem::path& path) {
+    if (!map.is_inside(p) || !map.is_passable(p)) {
+        throw std::runtime_error{
+            fmt::format("{}: the position ({}, {}) is not a free cell of the map",
+                        path.string(),
+                        p.row,
+                        p.col)};
+    }
+    return p;
+}
+
+/**
+ * Reads the agents and the tasks from an instance saved in the text format.
+ * @param text The contents of the instance.
+ * @param path The path of the instance, used in the error messages.
+ * @param map The map of the instance.
+ * @return the agents and the tasks.
+ */
+InstanceContents parse_text(std::string_view text,
+                            const std::filesystem::path& path,
+                            const AmbientMap& map) {
+    const auto malformed = [&path]() {
+        return std::runtime_error{fmt::format("{}: the instance is malformed", path.string())};
+    };
+    // reads a position, as a row and a column
+    const auto next_point = [&]() {
+        const auto row{next_int(text)};
+        const auto col{next_int(text)};
+        if (!row || !col) throw malformed();
+        return checked_point(map, {*row, *col}, path);
+    };
+
+    const auto num_agents{next_int(text)};
+    const auto num_tasks{next_int(text)};
+    if (!num_agents || !num_tasks || *num_agents < 0 || *num_tasks < 0) throw malformed();
+    InstanceContents contents;
+    contents.agents.reserve(*num_agents);
+    for (int i = 0; i < *num_agents; i++) {
+        contents.agents.push_back(next_point());
+    }
+    contents.tasks.reserve(*num_tasks);
+    for (int i = 0; i < *num_tasks; i++) {
+        const Point start{next_point()};
+        contents.tasks.emplace_back(start, next_point());
+    }
+    return contents;
+}
+
+/**
+ * Reads the agents and the tasks from a binary instance, see BinaryInstanceHeader.
+ * @param data The contents of the instance.
+ * @param path The path of the instance, used in the error messages.
+ * @param map The map of the instance.
+ * @return the agents and the tasks.
+ */
+InstanceContents parse_binary(std::string_view data,
+                              const std::filesystem::path& path,
+                              const AmbientMap& map) {
+    const auto malformed = [&path]() {
+        return std::runtime_error{
+            fmt::format("{}: the binary instance is malformed", path.string())};
+    };
+    BinaryInstanceHeader header{};
+    if (data.size() < sizeof(header)) throw malformed();
+    std::memcpy(&header, data.data(), sizeof(header));
+    if (header.version != binary_format_version) {
+        throw std::runtime_error{fmt::format("{}: the binary instance has version {} instead of {}",
+                                             path.string(),
+                                             header.version,
+                                             binary_format_version)};
+    }
+    if (header.num_agents < 0 || header.num_tasks < 0
+        || data.size()
+               != sizeof(header) + sizeof(Point) * static_cast<std::size_t>(header.num_agents)
+                      + 2 * sizeof(Point) * static_cast<std::size_t>(header.num_tasks)) {
+        throw malformed();
+    }
+    if (header.rows != map.rows_number() || header.columns != map.columns_number()) {
+        throw std::runtime_error{fmt::format(
+            "{}: the instance is for a {}x{} map", path.string(), header.rows, header.columns)};
+    }
+
+    // the positions are copied as they are, Point has the same layout as the file
+    InstanceContents contents;
+    const char* position{data.data() + sizeof(header)};
+    contents.agents.resize(header.num_agents, Point{0, 0});
+    std::memcpy(contents.agents.data(), position, sizeof(Point) * contents.agents.size());
+    position += sizeof(Point) * contents.agents.size();
+    contents.tasks.reserve(header.num_tasks);
+    for (int i = 0; i < header.num_tasks; ++i, position += 2 * sizeof(Point)) {
+        std::array<Point, 2> task{Point{0, 0}, Point{0, 0}};
+        std::memcpy(task.data(), position, sizeof(task));
+        contents.tasks.emplace_back(task[0], task[1]);
+    }
+    for (Point agent : contents.agents) {
+        checked_point(map, agent, path);
+    }
+    for (const auto& [start, goal] : contents.tasks) {
+        checked_point(map, start, path);
+        checked_point(map, goal, path);
+    }
+    return contents;
+}
+
+/**
+ * Reads the agents and the tasks from a MovingAI scenario.
+ * @param text The contents of the scenario.
+ * @param path The path of the scenario, used in the error messages.
+ * @param map The map of the scenario.
+ * @return the agents and the tasks.
+ */
+InstanceContents parse_scenario(std::string_view text,
+                                const std::filesystem::path& path,
+                                const AmbientMap& map) {
+    InstanceContents contents;
+    next_line(text);
+    for (int line_number = 2; !text.empty(); ++line_number) {
+        std::string_view line{next_line(text)};
+        if (line.find_first_not_of(" \t") == std::string_view::npos) continue;
+        // bucket map_name width height start_x start_y goal_x goal_y optimal_length
+        next_token(line);
+        next_token(line);
+        const auto width{next_int(line)};
+        const auto height{next_int(line)};
+        const auto start_col{next_int(line)};
+        const auto start_row{next_int(line)};
+        const auto goal_col{next_int(line)};
+        const auto goal_row{next_int(line)};
+        if (!width || !height || !start_col || !start_row || !goal_col || !goal_row) {
+            throw std::runtime_error{
+                fmt::format("{}:{}: the scenario is malformed", path.string(), line_number)};
+        }
+        if (*width != map.columns_number() || *height != map.rows_number()) {
+            throw std::runtime_error{fmt::format("{}:{}: the scenario is for a {}x{} map",
+                                                 path.string(),
+                                                 line_number,
+                                                 *width,
+                                                 *height)};
+        }
+        // every agent has to go from its start to its goal, like a task picked up where it is
+        const Point start{checked_point(map, {*start_row, *start_col}, path)};
+        contents.agents.push_back(start);
+        contents.tasks.emplace_back(start, checked_point(map, {*goal_row, *goal_col}, path));
+    }
+    return contents;
+}
+
+bool is_binary_instance(std::string_view contents) {
+    return contents.starts_with(
+        std::string_view{binary_instance_magic.data(), binary_instance_magic.size()});
+}
+
+InstanceContents load_instance(const std::filesystem::path& path, const AmbientMap& map) {
+    const MappedFile instance_file{path};
+    const std::string_view contents{instance_file.contents()};
+    if (is_binary_instance(contents)) return parse_binary(contents, path, map);
+    // MovingAI scenarios start with "version 1"
+    if (contents.starts_with("version")) return parse_scenario(contents, path, map);
+    return parse_text(contents, path, map);
+}
+
+void save_instance(const AmbientMap& map,
+                   const InstanceContents& contents,
+                   const std::filesystem::path& path,
+                   InstanceFormat format) {
+    const auto& [agents, tasks] = contents;
+    if (format == InstanceFormat::TEXT) {
+        std::string text{fmt::format("{} {}\n", agents.size(), tasks.size())};
+        for (Point a : agents) {
+            fmt::format_to(std::back_inserter(text), "{} {}\n", a.row, a.col);
+        }
+        for (const auto& [start, goal] : tasks) {
+            fmt::format_to(std::back_inserter(text),
+                           "{} {} {} {}\n",
+                           start.row,
+                           start.col,
+                           goal.row,
+                           goal.col);
+        }
+        write_file(path, text.data(), text.size());
+        return;
+    }
+
+    const BinaryInstanceHeader header{.magic = binary_instance_magic,
+                                      .version = binary_format_version,
+                                      .rows = map.rows_number(),
+                                      .columns = map.columns_number(),
+                                      .num_agents = static_cast<std::int32_t>(agents.size()),
+                                      .num_tasks = static_cast<std::int32_t>(tasks.size()),
+                                      .reserved = 0};
+    std::vector<std::int32_t> data(sizeof(header) / sizeof(std::int32_t));
+    std::memcpy(data.data(), &header, sizeof(header));
+    data.reserve(data.size() + 2 * agents.size() + 4 * tasks.size());
+    for (Point a : agents) {
+        data.insert(data.end(), {a.row, a.col});
+    }
+    for (const auto& [start, goal] : tasks) {
+        data.insert(data.end(), {start.row, start.col, goal.row, goal.col});
+    }
+    write_file(path, data.data(), sizeof(std::int32_t) * data.size());
+}
+
+void save_solution(const CmapdSolution& solution, const std::filesystem::path& path) {
+    const BinarySolutionHeader header{.magic = binary_solution_magic,
+                                      .version = binary_format_version,
+                                      .num_agents = static_cast<int>(solution.paths.size()),
+                                      .makespan = solution.makespan,
+                                      .cost = solution.cost};
+    std::vector<std::int32_t> data(sizeof(header) / sizeof(std::int32_t));
+    std::memcpy(data.data(), &header, sizeof(header));
+    for (const auto& path_to_save : solution.paths) {
+        data.push_back(static_cast<std::int32_t>(path_to_save.size()));
+    }
+    for (const auto& path_to_save : solution.paths) {
+        for (Point p : path_to_save) {
+            data.insert(data.end(), {p.row, p.col});
+        }
+    }
+    write_file(path, data.data(), sizeof(std::int32_t) * data.size());
+}
+
+CmapdSolution load_solution(const std::filesystem::path& path) {
+    const MappedFile solution_file{path};
+    const std::string_view contents{solution_file.contents()};
+    const auto malformed = [&path]() {
+        return std::runtime_error{fmt::format("{}: not a binary solution", path.string())};
+    };
+    BinarySolutionHeader header{};
+    if (contents.size() < sizeof(header)) throw malformed();
+    std::memcpy(&header, contents.data(), sizeof(header));
+    if (header.magic != binary_solution_magic || header.version != binary_format_version
+        || header.num_agents < 0) {
+        throw malformed();
+    }
+    const auto num_agents{static_cast<std::size_t>(header.num_agents)};
+    if (contents.size() < sizeof(header) + sizeof(std::int32_t) * num_agents) throw malformed();
+
+    std::vector<std::int32_t> lengths(num_agents);
+    std::memcpy(
+        lengths.data(), contents.data() + sizeof(header), sizeof(std::int32_t) * num_agents);
+    std::size_t num_points{0};
+    for (auto length : lengths) {
+        if (length < 0) throw malformed();
+        num_points += static_cast<std::size_t>(length);
+    }
+    const std::size_t points_offset{sizeof(header) + sizeof(std::int32_t) * num_agents};
+    if (contents.size() != points_offset + sizeof(Point) * num_points) throw malformed();
+
+    CmapdSolution solution{.paths = {}, .makespan = header.makespan, .cost = header.cost};
+    solution.paths.reserve(num_agents);
+    const char* points{contents.data() + points_offset};
+    for (auto length : lengths) {
+        // the paths are copied as they are, Point has the same layout as the file
+        path_t& agent_path{solution.paths.emplace_back(length, Point{0, 0})};
+        std::memcpy(agent_path.data(), points, sizeof(Point) * agent_path.size());
+        points += sizeof(Point) * agent_path.size();
+    }
+    return solution;
+}
+
+}  // namespace cmapd
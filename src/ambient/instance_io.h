@@ -0,0 +1,139 @@
+/**
+ * @file
+ * @brief Contains the binary formats of instances and solutions, and the functions to read and
+ * write instances and solutions.
+ * @author Davide Furlani
+ * @version 1.0
+ * @date November, 2022
+ * @copyright 2022 Jacopo Zagoli, Davide Furlani
+ */
+
+#pragma once
+#include <array>
+#include <bit>
+#include <cstdint>
+#include <filesystem>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "CmapdSolution.h"
+#include "Point.h"
+#include "ambient/AmbientMap.h"
+#include "ambient/InstanceFormat.h"
+
+namespace cmapd {
+
+// the binary files are read as they are, without converting the byte order
+static_assert(std::endian::native == std::endian::little, "The binary formats are little endian.");
+static_assert(std::is_trivially_copyable_v<Point> && sizeof(Point) == 2 * sizeof(std::int32_t),
+              "The binary formats store a Point as two 32 bits integers.");
+
+/// The first bytes of a binary instance.
+inline constexpr std::array<char, 8> binary_instance_magic{'C', 'M', 'A', 'P', 'D', 'I', 'N', 'S'};
+/// The first bytes of a binary solution.
+inline constexpr std::array<char, 8> binary_solution_magic{'C', 'M', 'A', 'P', 'D', 'S', 'O', 'L'};
+/// The version of the binary formats, increased at every incompatible change.
+inline constexpr std::uint32_t binary_format_version{1};
+
+/**
+ * @struct BinaryInstanceHeader
+ * @brief The beginning of a binary instance. It's followed by a (row, column) pair for every agent
+ * and by a (start row, start column, goal row, goal column) tuple for every task. All the numbers
+ * are little endian 32 bits integers, so that the file can be read without parsing it.
+ */
+struct BinaryInstanceHeader {
+    /// Always binary_instance_magic.
+    std::array<char, 8> magic;
+    /// The version of the format.
+    std::uint32_t version;
+    /// The number of rows of the map of the instance.
+    std::int32_t rows;
+    /// The number of columns of the map of the instance.
+    std::int32_t columns;
+    /// The number of agents.
+    std::int32_t num_agents;
+    /// The number of tasks.
+    std::int32_t num_tasks;
+    /// Unused, keeps the agents aligned to 8 bytes.
+    std::int32_t reserved;
+};
+static_assert(sizeof(BinaryInstanceHeader) == 32);
+
+/**
+ * @struct BinarySolutionHeader
+ * @brief The beginning of a binary solution. It's followed by the length of the path of every
+ * agent, and then by the (row, column) pairs of all the paths, one after the other. All the
+ * numbers are little endian 32 bits integers.
+ */
+struct BinarySolutionHeader {
+    /// Always binary_solution_magic.
+    std::array<char, 8> magic;
+    /// The version of the format.
+    std::uint32_t version;
+    /// The number of agents.
+    std::int32_t num_agents;
+    /// The makespan of the solution.
+    std::int32_t makespan;
+    /// The cost of the solution.
+    std::int32_t cost;
+};
+static_assert(sizeof(BinarySolutionHeader) == 24);
+
+/**
+ * @struct InstanceContents
+ * @brief The agents and the tasks of an instance, as they are saved in a file.
+ */
+struct InstanceContents {
+    /// The initial position of every agent.
+    std::vector<Point> agents;
+    /// The start and the goal of every task.
+    std::vector<std::pair<Point, Point>> tasks;
+};
+
+/**
+ * Checks if the contents of a file are a binary instance.
+ * @param contents The contents of the file.
+ * @return true if the file starts with binary_instance_magic.
+ */
+[[nodiscard]] bool is_binary_instance(std::string_view contents);
+/**
+ * Loads the agents and the tasks of an instance, saved in the text format, in the binary format
+ * or as a MovingAI scenario. In a scenario every entry is an agent in its start position, with a
+ * task from its start to its goal.
+ * @param path The path of the file.
+ * @param map The map of the instance, used to check the positions.
+ * @return the agents and the tasks.
+ * @throw runtime_error if the file does not exist, it's malformed or it's for another map.
+ */
+[[nodiscard]] InstanceContents load_instance(const std::filesystem::path& path,
+                                             const AmbientMap& map);
+/**
+ * Saves the agents and the tasks of an instance.
+ * @param map The map of the instance.
+ * @param contents The agents and the tasks to be saved.
+ * @param path The path of the file, which is overwritten.
+ * @param format The format of the file.
+ * @throw runtime_error if the file can't be written.
+ */
+void save_instance(const AmbientMap& map,
+                   const InstanceContents& contents,
+                   const std::filesystem::path& path,
+                   InstanceFormat format);
+/**
+ * Saves a solution in the binary format.
+ * @param solution The solution to be saved.
+ * @param path The path of the file, which is overwritten.
+ * @throw runtime_error if the file can't be written.
+ */
+void save_solution(const CmapdSolution& solution, const std::filesystem::path& path);
+/**
+ * Loads a solution saved in the binary format.
+ * @param path The path of the file.
+ * @return the solution.
+ * @throw runtime_error if the file does not exist or it's not a binary solution.
+ */
+[[nodiscard]] CmapdSolution load_solution(const std::filesystem::path& path);
+
+}  // namespace cmapd
@@ -8,23 +8,23 @@
  */
 
 #pragma once
-#include <map>
 #include <utility>
 #include <vector>
 
 #include "Point.h"
+#include "distances/DistanceTable.h"
 
 namespace cmapd {
 /// A type alias for a path, provided for ease of use.
 using path_t = std::vector<Point>;
 /** A type alias for the h-table, provided for ease of use.
- * h_table_t is a map which contains an entry for every non-wall cell 'A' of the instance.
- * Every entry contains a map with an entry for every starting and ending point 'B' of
- * every task. Every entry contains the distance between 'A' and 'B'.
+ * h_table_t is a dense table which contains the distance between every cell 'A' of the instance
+ * and every agent and every starting and ending point 'B' of every task.
  * For example, to get the distance between point (1,1) and (2,2) you should write
- * m_h_table.at({1,1}).at({2,2})
+ * m_h_table.distance({1,1}, {2,2}), or m_h_table.at({1,1}).at({2,2}) for a checked access.
+ * @see DistanceTable
  */
-using h_table_t = std::map<Point, std::map<Point, int>>;
+using h_table_t = DistanceTable;
 /// A type alias for a vector of "moves", or offset to a Point
 using moves_t = std::vector<std::pair<int, int>>;
 }  // namespace cmapd
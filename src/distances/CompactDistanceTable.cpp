@@ -0,0 +1,73 @@
+/**
+ * @file
+ * @brief Contains the implementation of class CompactDistanceTable.
+ * @author Jacopo Zagoli
+ * @version 1.0
+ * @date November, 2022
+ * @copyright 2022 Jacopo Zagoli, Davide Furlani
+ */
+
+#include "distances/CompactDistanceTable.h"
+
+#include <fmt/format.h>
+
+#include <cstddef>
+#include <stdexcept>
+#include <vector>
+
+#include "Point.h"
+#include "distances/DistanceTable.h"
+
+namespace cmapd {
+
+CompactDistanceTable::CompactDistanceTable(const DistanceTable& table)
+    : m_rows{table.rows_number()},
+      m_columns{table.columns_number()},
+      m_tiles_per_row{(m_columns + tile_columns - 1) / tile_columns},
+      m_tiles_per_poi{static_cast<std::size_t>((m_rows + tile_rows - 1) / tile_rows)
+                      * m_tiles_per_row},
+      m_pois{table.pois()},
+      m_poi_index(static_cast<std::size_t>(m_rows) * m_columns, -1) {
+    for (int poi = 0; poi < num_pois(); ++poi) {
+        m_poi_index[table.cell_index(m_pois[poi])] = poi;
+    }
+    // the cells of the padding of the last tiles are unreachable
+    m_tiles.assign(m_pois.size() * m_tiles_per_poi, Tile{});
+    for (int poi = 0; poi < num_pois(); ++poi) {
+        for (int row = 0; row < m_rows; ++row) {
+            for (int col = 0; col < m_columns; ++col) {
+                const int value{table.distance(table.cell_index({row, col}), poi)};
+                if (value > max_distance) {
+                    throw std::overflow_error{fmt::format(
+                        "The distance between ({}, {}) and ({}, {}) is larger than {}.",
+                        row,
+                        col,
+                        m_pois[poi].row,
+                        m_pois[poi].col,
+                        max_distance)};
+                }
+                const std::size_t tile{
+                    poi * m_tiles_per_poi
+                    + static_cast<std::size_t>(row / tile_rows) * m_tiles_per_row
+                    + col / tile_columns};
+                m_tiles[tile].values[row % tile_rows * tile_columns + col % tile_columns]
+                    = static_cast<std::uint16_t>(value + 1);
+            }
+        }
+    }
+}
+
+int CompactDistanceTable::rows_number() const { return m_rows; }
+
+int CompactDistanceTable::columns_number() const { return m_columns; }
+
+int CompactDistanceTable::num_pois() const { return static_cast<int>(m_pois.size()); }
+
+const std::vector<Point>& CompactDistanceTable::pois() const { return m_pois; }
+
+std::size_t CompactDistanceTable::memory_usage() const {
+    return sizeof(Tile) * m_tiles.size() + sizeof(int) * m_poi_index.size()
+           + sizeof(Point) * m_pois.size();
+}
+
+}  // namespace cmapd
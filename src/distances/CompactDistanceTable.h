@@ -0,0 +1,132 @@
+/**
+ * @file
+ * @brief Contains the class CompactDistanceTable.
+ * @author Jacopo Zagoli
+ * @version 1.0
+ * @date November, 2022
+ * @copyright 2022 Jacopo Zagoli, Davide Furlani
+ */
+
+#pragma once
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "Point.h"
+#include "distances/DistanceTable.h"
+
+namespace cmapd {
+
+/**
+ * @class CompactDistanceTable
+ * @brief A read-only copy of a DistanceTable, using 16 bits for every distance.
+ * Distances are stored increased by one, so that unreachable cells are stored as zero and the
+ * conversion back doesn't need any branch.
+ * The distances of a point of interest are divided in tiles of tile_rows x tile_columns
+ * neighbouring cells, and every tile fills a cache line. This way the distances of a cell and of
+ * its neighbours are usually in the same tile, and never in more than two.
+ */
+class CompactDistanceTable {
+  public:
+    /// The number of rows of cells in a tile, as a power of two.
+    static constexpr int tile_rows_log2{2};
+    /// The number of columns of cells in a tile, as a power of two.
+    static constexpr int tile_columns_log2{3};
+    /// The number of rows of cells in a tile.
+    static constexpr int tile_rows{1 << tile_rows_log2};
+    /// The number of columns of cells in a tile.
+    static constexpr int tile_columns{1 << tile_columns_log2};
+    /// The maximum distance which can be stored.
+    static constexpr int max_distance{0xFFFE};
+
+  private:
+    /**
+     * @struct Tile
+     * @brief The distances of a tile of cells from a point of interest, row by row.
+     */
+    struct alignas(64) Tile {
+        /// The distances of the cells of the tile.
+        std::array<std::uint16_t, tile_rows * tile_columns> values;
+    };
+
+    /// The number of rows of the map.
+    int m_rows{0};
+    /// The number of columns of the map.
+    int m_columns{0};
+    /// The number of tiles in a row of tiles.
+    int m_tiles_per_row{0};
+    /// The number of tiles of a point of interest.
+    std::size_t m_tiles_per_poi{0};
+    /// The points of interest, in the order of their index.
+    std::vector<Point> m_pois;
+    /// For every cell, the index of the point of interest in it, or -1 if there is none.
+    std::vector<int> m_poi_index;
+    /// The tiles, all the ones of a point of interest are contiguous.
+    std::vector<Tile> m_tiles;
+
+  public:
+    /// Constructs an empty table.
+    CompactDistanceTable() = default;
+    /**
+     * Constructs a compact copy of a table, with the same points of interest.
+     * @param table The table to be copied. Its lazy columns are completed.
+     * @throws overflow_error if a distance doesn't fit in 16 bits.
+     */
+    explicit CompactDistanceTable(const DistanceTable& table);
+    /// Get the number of rows of the map.
+    [[nodiscard]] int rows_number() const;
+    /// Get the number of columns of the map.
+    [[nodiscard]] int columns_number() const;
+    /// Get the number of points of interest.
+    [[nodiscard]] int num_pois() const;
+    /// Get the points of interest, in the order of their index.
+    [[nodiscard]] const std::vector<Point>& pois() const;
+    /**
+     * Get the index of a point of interest.
+     * @param p A point inside the map.
+     * @return the index of p, or -1 if p is not a point of interest.
+     */
+    [[nodiscard]] int poi_index(Point p) const;
+    /**
+     * Get the distance between a point and a point of interest, without any check.
+     * @param from A point inside the map.
+     * @param poi The point of interest index.
+     * @return the distance, or DistanceTable::unreachable.
+     */
+    [[nodiscard]] int distance(Point from, int poi) const;
+    /**
+     * Get the distance between a point and a point of interest, without any check.
+     * @param from A point inside the map.
+     * @param to A point of interest.
+     * @return the distance, or DistanceTable::unreachable.
+     */
+    [[nodiscard]] int distance(Point from, Point to) const;
+    /**
+     * Get the memory used by the table.
+     * @return the size of the table, in bytes.
+     */
+    [[nodiscard]] std::size_t memory_usage() const;
+};
+
+inline int CompactDistanceTable::poi_index(Point p) const {
+    return m_poi_index[static_cast<std::size_t>(p.row) * m_columns + p.col];
+}
+
+inline int CompactDistanceTable::distance(Point from, int poi) const {
+    const auto row{static_cast<unsigned>(from.row)};
+    const auto col{static_cast<unsigned>(from.col)};
+    const std::size_t tile{static_cast<std::size_t>(poi) * m_tiles_per_poi
+                           + static_cast<std::size_t>(row >> tile_rows_log2) * m_tiles_per_row
+                           + (col >> tile_columns_log2)};
+    const unsigned offset{((row & (tile_rows - 1)) << tile_columns_log2)
+                          | (col & (tile_columns - 1))};
+    // unreachable is stored as zero
+    return static_cast<int>(m_tiles[tile].values[offset]) - 1;
+}
+
+inline int CompactDistanceTable::distance(Point from, Point to) const {
+    return distance(from, poi_index(to));
+}
+
+}  // namespace cmapd
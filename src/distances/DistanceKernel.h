@@ -0,0 +1,26 @@
+/**
+ * @file
+ * @brief Contains the DistanceKernel enum.
+ * @author Jacopo Zagoli
+ * @version 1.0
+ * @date November, 2022
+ * @copyright 2022 Jacopo Zagoli, Davide Furlani
+ */
+
+#pragma once
+
+namespace cmapd {
+
+/**
+ * @enum DistanceKernel
+ * @brief Describes the algorithm used to fill the h-table.
+ */
+enum class DistanceKernel {
+    /// One BFS for every point of interest.
+    SCALAR,
+    /// No BFS: the distances from every point of interest are computed only when they are
+    /// queried, by a reverse resumable A* which expands only the needed cells.
+    LAZY
+};
+
+}  // namespace cmapd
@@ -0,0 +1,96 @@
+/**
+ * @file
+ * @brief Contains the implementation of class DistanceOracle.
+ * @author Jacopo Zagoli
+ * @version 1.0
+ * @date November, 2022
+ * @copyright 2022 Jacopo Zagoli, Davide Furlani
+ */
+
+#include "distances/DistanceOracle.h"
+
+#include <fmt/format.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <stdexcept>
+#include <vector>
+
+#include "ambient/AmbientMap.h"
+#include "custom_types.h"
+
+namespace cmapd {
+
+/**
+ * Checks that an h-table has the shape of the map of an oracle.
+ * @param h_table The h-table to be checked.
+ * @param rows The number of rows of the map.
+ * @param columns The number of columns of the map.
+ * @throws runtime_error if the shapes are different.
+ */
+void check_shape(const h_table_t& h_table, int rows, int columns) {
+    if (h_table.rows_number() != rows || h_table.columns_number() != columns) {
+        throw std::runtime_error{fmt::format("the h-table is {}x{}, but the map is {}x{}",
+                                             h_table.rows_number(),
+                                             h_table.columns_number(),
+                                             rows,
+                                             columns)};
+    }
+}
+
+DistanceOracle::DistanceOracle(const AmbientMap& map, std::size_t memory_budget)
+    : m_rows{map.rows_number()},
+      m_columns{map.columns_number()},
+      m_memory_budget{memory_budget} {}
+
+std::size_t DistanceOracle::column_size() const {
+    return sizeof(int) * static_cast<std::size_t>(m_rows) * m_columns;
+}
+
+std::vector<bool> DistanceOracle::load(h_table_t& h_table) {
+    check_shape(h_table, m_rows, m_columns);
+    std::vector<bool> loaded(h_table.num_pois(), false);
+    for (int poi = 0; poi < h_table.num_exact_pois(); ++poi) {
+        const auto found{m_index.find(h_table.cell_index(h_table.pois()[poi]))};
+        if (found == m_index.end()) continue;
+        ++m_hits;
+        // the column becomes the most recently used
+        m_columns_lru.splice(m_columns_lru.begin(), m_columns_lru, found->second);
+        const auto& distances{found->second->second};
+        std::copy(distances.begin(), distances.end(), h_table.column(poi).begin());
+        loaded[poi] = true;
+    }
+    return loaded;
+}
+
+void DistanceOracle::store(const h_table_t& h_table,
+                           const std::vector<bool>& loaded,
+                           std::size_t computed) {
+    check_shape(h_table, m_rows, m_columns);
+    m_misses += computed;
+    if (column_size() > m_memory_budget) return;
+    for (int poi = 0; poi < h_table.num_exact_pois(); ++poi) {
+        const int cell{h_table.cell_index(h_table.pois()[poi])};
+        if (loaded[poi] || m_index.contains(cell)) continue;
+        if (memory_usage() + column_size() > m_memory_budget) {
+            // reuse the buffer of the least recently used column
+            m_index.erase(m_columns_lru.back().first);
+            m_columns_lru.splice(
+                m_columns_lru.begin(), m_columns_lru, std::prev(m_columns_lru.end()));
+            m_columns_lru.front().first = cell;
+        } else {
+            m_columns_lru.emplace_front(cell, std::vector<int>(column_size() / sizeof(int)));
+        }
+        const auto column{h_table.column(poi)};
+        std::copy(column.begin(), column.end(), m_columns_lru.front().second.begin());
+        m_index[cell] = m_columns_lru.begin();
+    }
+}
+
+std::size_t DistanceOracle::size() const { return m_columns_lru.size(); }
+std::size_t DistanceOracle::memory_usage() const { return size() * column_size(); }
+std::size_t DistanceOracle::hits() const { return m_hits; }
+std::size_t DistanceOracle::misses() const { return m_misses; }
+
+}  // namespace cmapd
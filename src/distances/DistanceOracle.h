@@ -0,0 +1,83 @@
+/**
+ * @file
+ * @brief Contains the class DistanceOracle.
+ * @author Jacopo Zagoli
+ * @version 1.0
+ * @date November, 2022
+ * @copyright 2022 Jacopo Zagoli, Davide Furlani
+ */
+
+#pragma once
+#include <cstddef>
+#include <list>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "ambient/AmbientMap.h"
+#include "custom_types.h"
+
+namespace cmapd {
+
+/**
+ * @class DistanceOracle
+ * @brief Keeps in memory the distances from the points of interest of the instances of a map,
+ * so that instances on the same map compute the BFS only from cells never seen before.
+ * A column of distances is stored for every source cell, until their total size exceeds the
+ * memory budget: then the least recently used columns are discarded.
+ */
+class DistanceOracle {
+  private:
+    /// The number of rows of the map.
+    int m_rows;
+    /// The number of columns of the map.
+    int m_columns;
+    /// The maximum size of the stored columns, in bytes.
+    std::size_t m_memory_budget;
+    /// The stored columns with their source cell, from the most to the least recently used.
+    std::list<std::pair<int, std::vector<int>>> m_columns_lru;
+    /// For every source cell with a stored column, its position in m_columns_lru.
+    std::unordered_map<int, std::list<std::pair<int, std::vector<int>>>::iterator> m_index;
+    /// The number of columns found by load.
+    std::size_t m_hits{0};
+    /// The number of columns not found by load, which had to be computed.
+    std::size_t m_misses{0};
+
+    /// Get the size of a column, in bytes.
+    [[nodiscard]] std::size_t column_size() const;
+
+  public:
+    /**
+     * Constructs an empty oracle for the instances of a map.
+     * @param map The map of the instances.
+     * @param memory_budget The maximum size of the stored columns, in bytes.
+     */
+    DistanceOracle(const AmbientMap& map, std::size_t memory_budget);
+    /**
+     * Fills the columns of the h-table of the points of interest whose distances are stored.
+     * @param h_table The h-table to be filled, with the shape of the map.
+     * @return for every point of interest of the h-table, if its column was loaded.
+     * @throws runtime_error if the h-table doesn't have the shape of the map.
+     */
+    [[nodiscard]] std::vector<bool> load(h_table_t& h_table);
+    /**
+     * Stores the columns of the h-table that weren't loaded from the oracle, as the most recently
+     * used ones, discarding the least recently used columns if the memory budget is exceeded.
+     * @param h_table The h-table whose columns are stored.
+     * @param loaded For every point of interest of the h-table, if its column was loaded.
+     * @param computed The number of columns that were computed, instead of being loaded from the
+     * oracle or from somewhere else.
+     * @throws runtime_error if the h-table doesn't have the shape of the map.
+     */
+    void store(const h_table_t& h_table, const std::vector<bool>& loaded, std::size_t computed);
+    /// Get the number of stored columns.
+    [[nodiscard]] std::size_t size() const;
+    /// Get the size of the stored columns, in bytes.
+    [[nodiscard]] std::size_t memory_usage() const;
+    /// Get the number of columns found by load.
+    [[nodiscard]] std::size_t hits() const;
+    /// Get the number of columns not found by load, which had to be computed.
+    [[nodiscard]] std::size_t misses() const;
+};
+
+}  // namespace cmapd
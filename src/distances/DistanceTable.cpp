@@ -0,0 +1,202 @@
+/**
+ * @file
+ * @brief Contains the implementation of class DistanceTable.
+ * @author Jacopo Zagoli
+ * @version 1.0
+ * @date October, 2022
+ * @copyright 2022 Jacopo Zagoli, Davide Furlani
+ */
+
+#include "distances/DistanceTable.h"
+
+#include <fmt/format.h>
+
+#include <algorithm>
+#include <array>
+#include <cstdlib>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include "Point.h"
+#include "ambient/AmbientMap.h"
+
+namespace cmapd {
+
+DistanceTable::DistanceTable(int rows, int columns, const std::vector<Point>& pois)
+    : DistanceTable(rows, columns, pois, static_cast<int>(pois.size())) {}
+
+DistanceTable::DistanceTable(int rows, int columns, const std::vector<Point>& pois, int exact_pois)
+    : m_rows{rows},
+      m_columns{columns},
+      m_poi_index(static_cast<std::size_t>(rows) * columns, -1) {
+    for (Point poi : pois) {
+        if (poi_index(poi) == -1) {
+            m_poi_index[cell_index(poi)] = static_cast<int>(m_pois.size());
+            m_pois.push_back(poi);
+        }
+    }
+    m_exact_pois = std::clamp(exact_pois, 0, num_pois());
+    m_distances.assign(static_cast<std::size_t>(m_exact_pois) * m_poi_index.size(), unreachable);
+}
+
+int DistanceTable::rows_number() const { return m_rows; }
+
+int DistanceTable::columns_number() const { return m_columns; }
+
+int DistanceTable::num_cells() const { return static_cast<int>(m_poi_index.size()); }
+
+int DistanceTable::num_pois() const { return static_cast<int>(m_pois.size()); }
+
+int DistanceTable::num_exact_pois() const { return m_exact_pois; }
+
+int DistanceTable::num_landmarks() const { return m_num_landmarks; }
+
+const std::vector<Point>& DistanceTable::pois() const { return m_pois; }
+
+void DistanceTable::set_lazy_columns(std::shared_ptr<const AmbientMap> map,
+                                     const std::vector<int>& pois) {
+    if (pois.empty()) return;
+    m_map = std::move(map);
+    m_searches.resize(m_pois.size());
+    for (int poi : pois) {
+        m_searches[poi].closed.assign(m_poi_index.size(), false);
+    }
+}
+
+void DistanceTable::set_landmarks(int num_landmarks, std::vector<int> distances) {
+    m_num_landmarks = num_landmarks;
+    m_landmark_distances = std::move(distances);
+}
+
+int DistanceTable::estimated_distance(int cell, int poi) const {
+    const std::size_t landmarks{static_cast<std::size_t>(m_num_landmarks)};
+    const int* from{m_landmark_distances.data() + cell * landmarks};
+    const int* to{m_landmark_distances.data() + cell_index(m_pois[poi]) * landmarks};
+    int estimate{0};
+    for (std::size_t landmark = 0; landmark < landmarks; ++landmark) {
+        if ((from[landmark] == unreachable) != (to[landmark] == unreachable)) {
+            // they are in different connected components
+            return unreachable;
+        }
+        estimate = std::max(estimate, std::abs(from[landmark] - to[landmark]));
+    }
+    return estimate;
+}
+
+bool DistanceTable::is_complete(int poi) const {
+    return m_searches.empty() || m_searches[poi].closed.empty();
+}
+
+int DistanceTable::lazy_distance(int cell, int poi) const {
+    const std::size_t offset{static_cast<std::size_t>(poi) * m_poi_index.size()};
+    auto& [closed, open, target] = m_searches[poi];
+    if (closed.empty() || closed[cell]) return m_distances[offset + cell];
+    if (target == -1) {
+        // the search starts, directed toward the first queried cell
+        target = cell;
+        const int root{cell_index(m_pois[poi])};
+        m_distances[offset + root] = 0;
+        open.push_back({0, 0, root});
+    }
+    // the manhattan distance from the target, consistent on a 4-connected grid
+    auto heuristic = [this, target_row = target / m_columns, target_col = target % m_columns](
+                         int c) {
+        return std::abs(c / m_columns - target_row) + std::abs(c % m_columns - target_col);
+    };
+    // lower f-values first, then higher g-values
+    auto worse = [](const std::array<int, 3>& lhs, const std::array<int, 3>& rhs) {
+        return lhs[0] > rhs[0] || (lhs[0] == rhs[0] && lhs[1] < rhs[1]);
+    };
+    while (!closed[cell] && !open.empty()) {
+        std::pop_heap(open.begin(), open.end(), worse);
+        const auto [f_value, g_value, current] = open.back();
+        open.pop_back();
+        if (closed[current]) continue;
+        closed[current] = true;
+        // the cell itself, the first of its neighbours, is already closed
+        for (const int child : m_map->neighbours(current)) {
+            if (closed[child]) continue;
+            int& child_distance{m_distances[offset + child]};
+            if (child_distance == unreachable || g_value + 1 < child_distance) {
+                child_distance = g_value + 1;
+                open.push_back({child_distance + heuristic(child), child_distance, child});
+                std::push_heap(open.begin(), open.end(), worse);
+            }
+        }
+    }
+    const int value{closed[cell] ? m_distances[offset + cell] : unreachable};
+    if (open.empty()) {
+        // every reachable cell is closed, the column is complete
+        closed = {};
+        open = {};
+    }
+    return value;
+}
+
+bool DistanceTable::operator==(const DistanceTable& rhs) const {
+    if (m_rows != rhs.m_rows || m_columns != rhs.m_columns || m_pois != rhs.m_pois) {
+        return false;
+    }
+    if (m_map == nullptr && rhs.m_map == nullptr && m_exact_pois == num_pois()
+        && rhs.m_exact_pois == rhs.num_pois()) {
+        return m_distances == rhs.m_distances;
+    }
+    for (int poi = 0; poi < num_pois(); ++poi) {
+        for (int cell = 0; cell < num_cells(); ++cell) {
+            if (distance(cell, poi) != rhs.distance(cell, poi)) return false;
+        }
+    }
+    return true;
+}
+
+DistanceTable::Row DistanceTable::at(Point from) const {
+    if (from.row < 0 || from.row >= m_rows || from.col < 0 || from.col >= m_columns) {
+        throw std::out_of_range{fmt::format("({}, {}) is outside the map", from.row, from.col)};
+    }
+    const int cell{cell_index(from)};
+    for (int poi = 0; poi < num_pois(); ++poi) {
+        if (distance(cell, poi) != unreachable) return {*this, cell};
+    }
+    throw std::out_of_range{
+        fmt::format("({}, {}) can't reach any point of interest", from.row, from.col)};
+}
+
+std::size_t DistanceTable::size() const {
+    std::size_t reachable{0};
+    for (int cell = 0; cell < num_cells(); ++cell) {
+        for (int poi = 0; poi < num_pois(); ++poi) {
+            if (distance(cell, poi) != unreachable) {
+                ++reachable;
+                break;
+            }
+        }
+    }
+    return reachable;
+}
+
+std::size_t DistanceTable::memory_usage() const {
+    return sizeof(int) * (m_poi_index.size() + m_distances.size() + m_landmark_distances.size())
+           + sizeof(Point) * m_pois.size();
+}
+
+DistanceTable::Row::Row(const DistanceTable& table, int cell)
+    : m_table{&table},
+      m_cell{cell} {}
+
+int DistanceTable::Row::at(Point to) const {
+    if (to.row < 0 || to.row >= m_table->m_rows || to.col < 0 || to.col >= m_table->m_columns
+        || m_table->poi_index(to) == -1) {
+        throw std::out_of_range{
+            fmt::format("({}, {}) is not a point of interest", to.row, to.col)};
+    }
+    const int value{m_table->distance(m_cell, m_table->poi_index(to))};
+    if (value == unreachable) {
+        throw std::out_of_range{fmt::format("({}, {}) can't be reached", to.row, to.col)};
+    }
+    return value;
+}
+
+std::size_t DistanceTable::Row::size() const { return m_table->m_pois.size(); }
+
+}  // namespace cmapd
@@ -0,0 +1,281 @@
+/**
+ * @file
+ * @brief Contains the class DistanceTable.
+ * @author Jacopo Zagoli
+ * @version 1.0
+ * @date October, 2022
+ * @copyright 2022 Jacopo Zagoli, Davide Furlani
+ */
+
+#pragma once
+#include <array>
+#include <cstddef>
+#include <memory>
+#include <span>
+#include <vector>
+
+#include "Point.h"
+
+namespace cmapd {
+
+class AmbientMap;
+
+/**
+ * @class DistanceTable
+ * @brief A dense table containing the distance between every cell of a map and every point of
+ * interest (agents and tasks endpoints) of an instance.
+ * Cells are identified by row * columns + column, points of interest by the order in which they
+ * are provided to the constructor. Distances of a single point of interest are stored
+ * contiguously, so that neighbouring cells have neighbouring distances.
+ * The columns of some points of interest can be lazy: they are filled by a reverse resumable A*
+ * only as far as needed by the queried distances, so a table with lazy columns can't be read by
+ * more threads at the same time.
+ * To bound the memory, only the first points of interest can have a column: the distances from
+ * the other ones are estimated from the distances of a few landmark cells, using the triangle
+ * inequality (ALT heuristic). Estimated distances are never greater than the real ones.
+ */
+class DistanceTable {
+  public:
+    /// The value stored for cells which can't reach a point of interest (walls included).
+    static constexpr int unreachable{-1};
+
+    /**
+     * @class Row
+     * @brief A view over the distances between one cell and every point of interest.
+     * It mimics the interface of the std::map previously used as h-table.
+     */
+    class Row {
+      private:
+        const DistanceTable* m_table;
+        int m_cell;
+
+      public:
+        /**
+         * Constructs a view on a row of the table.
+         * @param table The viewed table.
+         * @param cell The cell index of the row.
+         */
+        Row(const DistanceTable& table, int cell);
+        /**
+         * Get the distance to a point of interest.
+         * @param to The point of interest.
+         * @return the distance between the row cell and to.
+         * @throws out_of_range if to is not a point of interest or it can't be reached.
+         */
+        [[nodiscard]] int at(Point to) const;
+        /// Get the number of points of interest.
+        [[nodiscard]] std::size_t size() const;
+    };
+
+  private:
+    /**
+     * @struct LazySearch
+     * @brief The state of the reverse resumable A* filling a lazy column. The A* starts from the
+     * point of interest and is directed toward the first queried cell, the tentative distances
+     * of the open cells are stored in the column.
+     */
+    struct LazySearch {
+        /// For every cell, if its distance is final. Empty if the column is complete.
+        std::vector<bool> closed;
+        /// The open cells, as a heap of (f-value, g-value, cell).
+        std::vector<std::array<int, 3>> open;
+        /// The cell toward which the search is directed, or -1 if the search hasn't started.
+        int target{-1};
+    };
+
+    /// The number of rows of the map.
+    int m_rows{0};
+    /// The number of columns of the map.
+    int m_columns{0};
+    /// The points of interest, in the order of their index.
+    std::vector<Point> m_pois;
+    /// For every cell, the index of the point of interest in it, or -1 if there is none.
+    std::vector<int> m_poi_index;
+    /// The number of points of interest with a column, the first ones.
+    int m_exact_pois{0};
+    /// The distances, one contiguous column of cells for every point of interest with a column.
+    mutable std::vector<int> m_distances;
+    /// The number of landmarks.
+    int m_num_landmarks{0};
+    /// For every cell, the distances from every landmark.
+    std::vector<int> m_landmark_distances;
+    /// The map searched by the lazy columns. Null if there are no lazy columns.
+    std::shared_ptr<const AmbientMap> m_map;
+    /// For every point of interest, the search filling its column if it is lazy.
+    mutable std::vector<LazySearch> m_searches;
+
+    /**
+     * Get the distance between a cell and a point of interest of a table with lazy columns,
+     * resuming the search of the column until the distance of the cell is final.
+     * @param cell The cell index.
+     * @param poi The point of interest index.
+     * @return the distance, or unreachable.
+     */
+    [[nodiscard]] int lazy_distance(int cell, int poi) const;
+    /**
+     * Get a lower bound of the distance between a cell and a point of interest without a column,
+     * the maximum difference between their distances from a landmark.
+     * @param cell The cell index.
+     * @param poi The point of interest index.
+     * @return the estimated distance, or unreachable if a landmark reaches only one of them.
+     */
+    [[nodiscard]] int estimated_distance(int cell, int poi) const;
+
+  public:
+    /// Constructs an empty table.
+    DistanceTable() = default;
+    /**
+     * Constructs a table where every distance is unreachable.
+     * @param rows The number of rows of the map.
+     * @param columns The number of columns of the map.
+     * @param pois The points of interest. Duplicates are stored only once.
+     */
+    DistanceTable(int rows, int columns, const std::vector<Point>& pois);
+    /**
+     * Constructs a table where every distance is unreachable, with a column only for some points
+     * of interest. The other ones need landmarks to estimate their distances.
+     * @param rows The number of rows of the map.
+     * @param columns The number of columns of the map.
+     * @param pois The points of interest. Duplicates are stored only once.
+     * @param exact_pois The maximum number of points of interest with a column, the first ones.
+     */
+    DistanceTable(int rows, int columns, const std::vector<Point>& pois, int exact_pois);
+    /// Get the number of rows of the map.
+    [[nodiscard]] int rows_number() const;
+    /// Get the number of columns of the map.
+    [[nodiscard]] int columns_number() const;
+    /// Get the number of cells of the map.
+    [[nodiscard]] int num_cells() const;
+    /// Get the number of points of interest.
+    [[nodiscard]] int num_pois() const;
+    /// Get the number of points of interest with a column, which are the first ones.
+    [[nodiscard]] int num_exact_pois() const;
+    /// Get the number of landmarks.
+    [[nodiscard]] int num_landmarks() const;
+    /// Get the points of interest, in the order of their index.
+    [[nodiscard]] const std::vector<Point>& pois() const;
+    /**
+     * Get the index of a cell.
+     * @param p A point inside the map.
+     * @return the cell index of p.
+     */
+    [[nodiscard]] int cell_index(Point p) const;
+    /**
+     * Get the index of a point of interest.
+     * @param p A point inside the map.
+     * @return the index of p, or -1 if p is not a point of interest.
+     */
+    [[nodiscard]] int poi_index(Point p) const;
+    /**
+     * Get the distance between a cell and a point of interest, without any check.
+     * @param cell The cell index.
+     * @param poi The point of interest index.
+     * @return the distance, or unreachable.
+     */
+    [[nodiscard]] int distance(int cell, int poi) const;
+    /**
+     * Get the distance between a point and a point of interest, without any check.
+     * @param from A point inside the map.
+     * @param to A point of interest.
+     * @return the distance, or unreachable.
+     */
+    [[nodiscard]] int distance(Point from, Point to) const;
+    /**
+     * Set the distance between a cell and a point of interest.
+     * @param cell The cell index.
+     * @param poi The index of a point of interest with a column.
+     * @param distance The distance to be stored.
+     */
+    void set_distance(int cell, int poi, int distance);
+    /**
+     * Makes the columns of some points of interest lazy: their distances are computed only when
+     * they are queried. The columns must contain only unreachable values.
+     * @param map The map of the table, whose neighbours are searched.
+     * @param pois The indexes of the points of interest whose columns become lazy.
+     */
+    void set_lazy_columns(std::shared_ptr<const AmbientMap> map, const std::vector<int>& pois);
+    /**
+     * Sets the landmarks used to estimate the distances from the points of interest without a
+     * column.
+     * @param num_landmarks The number of landmarks.
+     * @param distances For every cell, the distances from every landmark, or unreachable.
+     */
+    void set_landmarks(int num_landmarks, std::vector<int> distances);
+    /**
+     * Checks if the column of a point of interest contains all its final distances.
+     * @param poi The index of a point of interest with a column.
+     * @return false if the column is lazy and its search isn't finished.
+     */
+    [[nodiscard]] bool is_complete(int poi) const;
+    /**
+     * Get the distances of a point of interest from every cell.
+     * @param poi The index of a point of interest with a column.
+     * @return the column of poi, indexed by cell. It is partial if the column isn't complete.
+     */
+    [[nodiscard]] std::span<const int> column(int poi) const;
+    /**
+     * Get the distances of a point of interest from every cell.
+     * @param poi The index of a point of interest with a column.
+     * @return the column of poi, indexed by cell.
+     */
+    [[nodiscard]] std::span<int> column(int poi);
+    /**
+     * Get a checked view over the distances of a point, like the old h-table.
+     * For example, to get the distance between point (1,1) and (2,2) you can write
+     * h_table.at({1,1}).at({2,2})
+     * @param from A point.
+     * @return A view over the distances between from and every point of interest.
+     * @throws out_of_range if from is outside the map or can't reach any point of interest.
+     */
+    [[nodiscard]] Row at(Point from) const;
+    /**
+     * Get the number of cells which can reach at least one point of interest.
+     * It visits the whole table.
+     * @return the number of reachable cells.
+     */
+    [[nodiscard]] std::size_t size() const;
+    /**
+     * Get the memory used by the table, excluding the state of the searches of lazy columns.
+     * @return the size of the table, in bytes.
+     */
+    [[nodiscard]] std::size_t memory_usage() const;
+    /**
+     * Two tables are equal if they have the same shape, points of interest and distances.
+     * Lazy columns are completed to be compared.
+     */
+    [[nodiscard]] bool operator==(const DistanceTable& rhs) const;
+};
+
+inline int DistanceTable::cell_index(Point p) const { return p.row * m_columns + p.col; }
+
+inline int DistanceTable::poi_index(Point p) const { return m_poi_index[cell_index(p)]; }
+
+inline int DistanceTable::distance(int cell, int poi) const {
+    if (poi >= m_exact_pois) [[unlikely]] {
+        return estimated_distance(cell, poi);
+    }
+    if (m_map != nullptr) [[unlikely]] {
+        return lazy_distance(cell, poi);
+    }
+    return m_distances[static_cast<std::size_t>(poi) * m_poi_index.size() + cell];
+}
+
+inline int DistanceTable::distance(Point from, Point to) const {
+    return distance(cell_index(from), poi_index(to));
+}
+
+inline void DistanceTable::set_distance(int cell, int poi, int distance) {
+    m_distances[static_cast<std::size_t>(poi) * m_poi_index.size() + cell] = distance;
+}
+
+inline std::span<const int> DistanceTable::column(int poi) const {
+    return {m_distances.data() + static_cast<std::size_t>(poi) * m_poi_index.size(),
+            m_poi_index.size()};
+}
+
+inline std::span<int> DistanceTable::column(int poi) {
+    return {m_distances.data() + static_cast<std::size_t>(poi) * m_poi_index.size(),
+            m_poi_index.size()};
+}
+
+}  // namespace cmapd
@@ -0,0 +1,39 @@
+/**
+ * @file
+ * @brief Contains the struct DistancesConfig.
+ * @author Jacopo Zagoli
+ * @version 1.0
+ * @date November, 2022
+ * @copyright 2022 Jacopo Zagoli, Davide Furlani
+ */
+
+#pragma once
+#include <cstddef>
+#include <filesystem>
+
+#include "distances/DistanceKernel.h"
+
+namespace cmapd {
+
+class DistanceOracle;
+
+/**
+ * @struct DistancesConfig
+ * @brief Contains the options used to compute the h-table of an instance.
+ */
+struct DistancesConfig {
+    /// The number of threads to use. If zero, the hardware concurrency is used.
+    int threads{0};
+    /// The algorithm used to compute the distances.
+    DistanceKernel kernel{DistanceKernel::SCALAR};
+    /// The directory containing the h-table cache files. If empty, the cache is not used.
+    std::filesystem::path cache_directory{};
+    /// The oracle shared by the instances of the same map. If null, the oracle is not used.
+    DistanceOracle* oracle{nullptr};
+    /// The maximum size of the h-table, in bytes. If zero, the h-table has no limit.
+    std::size_t memory_budget{0};
+    /// The number of landmarks used to estimate the distances that don't fit the memory budget.
+    int landmarks{16};
+};
+
+}  // namespace cmapd
@@ -2,7 +2,7 @@
  * @file
  * @brief Contains the implementation of distances methods.
  * @author Jacopo Zagoli
- * @version 2.0
+ * @version 3.1
  * @date October, 2022
  * @copyright 2022 Jacopo Zagoli, Davide Furlani
  */
@@ -10,51 +10,195 @@
 #include "distances/distances.h"
 
 #include <algorithm>
-#include <list>
-#include <set>
+#include <atomic>
+#include <cstddef>
+#include <limits>
+#include <span>
+#include <thread>
+#include <utility>
+#include <vector>
 
 #include "Point.h"
 #include "ambient/AmbientMapInstance.h"
 #include "custom_types.h"
-#include "distances/Node.h"
+#include "distances/DistanceKernel.h"
+#include "distances/DistanceOracle.h"
+#include "distances/DistanceTable.h"
+#include "distances/DistancesConfig.h"
+#include "distances/h_table_cache.h"
 
 namespace cmapd {
 
-h_table_t compute_h_table(const AmbientMapInstance& map_instance) {
-    h_table_t h_table;
-    // Creation of a list with all points of interests (agents and tasks)
-    std::vector<Point> poi{map_instance.agents()};
+/**
+ * Fills a column of distances with a BFS starting from a cell.
+ * The column itself marks the visited cells, since only their distance is not unreachable, and
+ * every cell enters the queue at most once, so the search is linear in the number of cells.
+ * @param map_instance The AmbientMapInstance on which the BFS is done.
+ * @param root The cell index from which the BFS starts.
+ * @param distances The column to be filled, indexed by cell, it must contain only unreachable
+ * values.
+ * @param queue A buffer with room for every cell of the map, used as the BFS queue.
+ */
+void bfs(const AmbientMapInstance& map_instance,
+         int root,
+         std::span<int> distances,
+         std::vector<int>& queue) {
+    std::size_t head{0};
+    std::size_t tail{0};
+    queue[tail++] = root;
+    distances[root] = 0;
+    while (head != tail) {
+        // get first cell and remove it
+        const int cell{queue[head++]};
+        const int child_cost{distances[cell] + 1};
+        // generate child cells, the cell itself is already reached
+        for (const int child_cell : map_instance.neighbours(cell)) {
+            if (distances[child_cell] == DistanceTable::unreachable) {
+                distances[child_cell] = child_cost;
+                queue[tail++] = child_cell;
+            }
+        }
+    }
+}
+
+/**
+ * Fills the columns of some points of interest of the h-table with a BFS from each of them, using
+ * the number of threads of config.
+ * Every BFS writes only in the columns of its points of interest, so threads don't need any lock
+ * and the result doesn't depend on how the points of interest are distributed between them.
+ * @param map_instance The AmbientMapInstance on which the BFS are done.
+ * @param h_table The h-table to be filled, whose columns must contain only unreachable values.
+ * @param pois The indexes of the points of interest whose columns are filled.
+ * @param config The options used to compute the distances.
+ */
+void fill_columns(const AmbientMapInstance& map_instance,
+                  h_table_t& h_table,
+                  const std::vector<int>& pois,
+                  const DistancesConfig& config) {
+    // We do a BFS starting from every poi
+    const auto n_pois{static_cast<int>(pois.size())};
+    int threads{config.threads};
+    if (threads <= 0) {
+        threads = static_cast<int>(std::thread::hardware_concurrency());
+    }
+    threads = std::max(1, std::min(threads, n_pois));
+    std::atomic<int> next_poi{0};
+    auto worker = [&]() {
+        std::vector<int> queue(h_table.num_cells());
+        for (int i = next_poi++; i < n_pois; i = next_poi++) {
+            const int poi{pois[i]};
+            bfs(map_instance, h_table.cell_index(h_table.pois()[poi]), h_table.column(poi), queue);
+        }
+    };
+    {
+        std::vector<std::jthread> pool;
+        for (int i = 1; i < threads; ++i) {
+            pool.emplace_back(worker);
+        }
+        worker();
+    }
+}
+
+/**
+ * Sets the landmarks of the h-table, chosen one at a time as the cell farthest from the previous
+ * ones, starting from the cell farthest from the first point of interest. Cells not reached by the
+ * previous landmarks are the farthest ones, so every connected component gets a landmark.
+ * @param map_instance The AmbientMapInstance on which the BFS are done.
+ * @param h_table The h-table whose landmarks are set.
+ * @param num_landmarks The maximum number of landmarks.
+ */
+void set_landmarks(const AmbientMapInstance& map_instance, h_table_t& h_table, int num_landmarks) {
+    const int num_cells{h_table.num_cells()};
+    // for every cell, the distance from the nearest landmark, or -1 for walls
+    std::vector<int> nearest(num_cells, -1);
+    const int width{h_table.columns_number()};
+    for (int cell = 0; cell < num_cells; ++cell) {
+        if (map_instance.is_passable({cell / width, cell % width})) {
+            nearest[cell] = std::numeric_limits<int>::max();
+        }
+    }
+    std::vector<int> queue(num_cells);
+    std::vector<int> column(num_cells, DistanceTable::unreachable);
+    bfs(map_instance, h_table.cell_index(h_table.pois()[0]), column, queue);
+    int landmark{static_cast<int>(std::ranges::max_element(column) - column.begin())};
+    std::vector<std::vector<int>> columns;
+    while (std::ssize(columns) < num_landmarks && nearest[landmark] > 0) {
+        std::ranges::fill(column, DistanceTable::unreachable);
+        bfs(map_instance, landmark, column, queue);
+        for (int cell = 0; cell < num_cells; ++cell) {
+            if (column[cell] != DistanceTable::unreachable) {
+                nearest[cell] = std::min(nearest[cell], column[cell]);
+            }
+        }
+        columns.push_back(column);
+        landmark = static_cast<int>(std::ranges::max_element(nearest) - nearest.begin());
+    }
+    // the distances from the landmarks of a cell are contiguous
+    const auto landmarks{columns.size()};
+    std::vector<int> distances(landmarks * num_cells);
+    for (std::size_t i = 0; i < landmarks; ++i) {
+        for (int cell = 0; cell < num_cells; ++cell) {
+            distances[cell * landmarks + i] = columns[i][cell];
+        }
+    }
+    h_table.set_landmarks(static_cast<int>(landmarks), std::move(distances));
+}
+
+h_table_t compute_h_table(const AmbientMapInstance& map_instance, const DistancesConfig& config) {
+    // Creation of a list with all points of interests (tasks and agents). Tasks come first,
+    // because their columns are the ones used by the A* heuristic.
+    std::vector<Point> poi;
     for (auto& [start, goal] : map_instance.tasks()) {
         poi.push_back(start);
         poi.push_back(goal);
     }
-    // We do a BFS starting from every poi to every other location on the map
-    // iterate over every poi
-    using namespace bfs;
-    for (Point destination : poi) {
-        // BFS algorithm
-        Node root{destination};
-        std::list<Node> frontier;
-        std::set<Point> explored;
-        frontier.push_back(root);
-        while (!frontier.empty()) {
-            // get first node and remove it
-            Node node{frontier.front()};
-            frontier.pop_front();
-            // update h-table
-            h_table[node.point][destination] = node.path_cost;
-            // mark point as explored
-            explored.insert(node.point);
-            // generate child nodes
-            for (moves_t moves{{0, 1}, {1, 0}, {0, -1}, {-1, 0}}; const auto& move : moves) {
-                Node child{node.point + move, node.path_cost + 1};
-                // check if child is valid or is in explored or frontier
-                if (map_instance.is_valid(child.point) && !explored.contains(child.point)
-                    && std::find(frontier.cbegin(), frontier.cend(), child) == frontier.cend()) {
-                    frontier.push_back(child);
-                }
-            }
-        }
+    poi.insert(poi.end(), map_instance.agents().begin(), map_instance.agents().end());
+    // With a memory budget, only the columns that fit are stored, next to the landmarks
+    const std::size_t column_size{sizeof(int) * map_instance.rows_number()
+                                  * map_instance.columns_number()};
+    auto exact_pois{static_cast<int>(poi.size())};
+    if (config.memory_budget > 0 && (poi.size() + 1) * column_size > config.memory_budget) {
+        const std::size_t landmarks_size{static_cast<std::size_t>(config.landmarks + 1)
+                                         * column_size};
+        exact_pois = static_cast<int>(
+            config.memory_budget > landmarks_size
+                ? (config.memory_budget - landmarks_size) / column_size
+                : 0);
+    }
+    h_table_t h_table{
+        map_instance.rows_number(), map_instance.columns_number(), poi, exact_pois};
+    if (h_table.num_exact_pois() < h_table.num_pois()) {
+        set_landmarks(map_instance, h_table, config.landmarks);
+    }
+    // Columns found in the oracle or in the cache don't need to be computed, and the cache is read
+    // only for the columns the oracle doesn't have
+    std::vector<bool> from_oracle(h_table.num_pois(), false);
+    if (config.oracle != nullptr) {
+        from_oracle = config.oracle->load(h_table);
+    }
+    const auto exact_end{from_oracle.begin() + h_table.num_exact_pois()};
+    const bool use_cache{!config.cache_directory.empty()
+                         && std::find(from_oracle.begin(), exact_end, false) != exact_end};
+    const auto hash{use_cache ? h_table_cache::map_hash(map_instance) : 0};
+    std::vector<bool> from_cache(h_table.num_pois(), false);
+    if (use_cache) {
+        from_cache = h_table_cache::load(config.cache_directory, hash, h_table, from_oracle);
+    }
+    std::vector<int> missing;
+    for (int poi_index = 0; poi_index < h_table.num_exact_pois(); ++poi_index) {
+        if (!from_oracle[poi_index] && !from_cache[poi_index]) missing.push_back(poi_index);
+    }
+    if (config.kernel == DistanceKernel::LAZY) {
+        // lazy columns are incomplete, so they are neither stored in the cache nor in the oracle
+        h_table.set_lazy_columns(map_instance.shared_ambient_map(), missing);
+        return h_table;
+    }
+    fill_columns(map_instance, h_table, missing, config);
+    if (use_cache && !missing.empty()) {
+        h_table_cache::store(config.cache_directory, hash, h_table, from_cache);
+    }
+    if (config.oracle != nullptr) {
+        config.oracle->store(h_table, from_oracle, missing.size());
     }
     return h_table;
 }
@@ -62,9 +206,9 @@ h_table_t compute_h_table(const AmbientMapInstance& map_instance) {
 namespace multi_a_star {
 
 int compute_h_value(Point x, int label, const h_table_t& h_table, const path_t& goal_sequence) {
-    int h_value{h_table.at(x).at(goal_sequence[label])};
+    int h_value{h_table.distance(x, goal_sequence[label])};
     for (int j{label + 1}; j < goal_sequence.size(); ++j) {
-        h_value += h_table.at(goal_sequence[j - 1]).at(goal_sequence[j]);
+        h_value += h_table.distance(goal_sequence[j - 1], goal_sequence[j]);
     }
     return h_value;
 }
@@ -12,16 +12,27 @@
 #include "Point.h"
 #include "ambient/AmbientMapInstance.h"
 #include "custom_types.h"
+#include "distances/DistancesConfig.h"
 
 namespace cmapd {
 
 /**
  * Computes the m_h_table for the provided map_instance.
  * Contains the distance from every non-wall cell to every task and agent.
+ * The BFS of every task and agent are distributed among threads, the result doesn't depend
+ * on their number nor on the chosen kernel. If an oracle or a cache directory are set, the
+ * distances already stored there are loaded instead of being computed, and the new ones are
+ * added to them. The cache is read only if the oracle doesn't contain every distance. With the
+ * lazy kernel the missing distances are computed only when they are queried. If the h-table
+ * doesn't fit the memory budget, the distances from the points of interest that don't fit are
+ * estimated with landmarks, tasks endpoints are the first to get the exact ones.
  * @param map_instance The AmbientMapInstance for which the m_h_table is calculated.
+ * @param config The options used to compute the distances.
  * @return The computed m_h_table.
+ * @throws runtime_error if the cache file can't be written.
  */
-[[nodiscard]] h_table_t compute_h_table(const AmbientMapInstance& map_instance);
+[[nodiscard]] h_table_t compute_h_table(const AmbientMapInstance& map_instance,
+                                        const DistancesConfig& config = {});
 
 namespace multi_a_star {
 /**
@@ -33,6 +44,7 @@ namespace multi_a_star {
  * @param h_table The h-table (table of distances) for the desired map instance.
  * @param goal_sequence The goals the current A* path needs to visit.
  * @return The distance of location to the goals, according to label.
+ * @see GoalSequence, which computes the same value without visiting the whole goal_sequence.
  * @see Lifelong Multi-Agent Path Finding in Large-Scale Warehouses, section 4.1
  */
 int compute_h_value(Point location,
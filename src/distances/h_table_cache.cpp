@@ -0,0 +1,262 @@
+/**
+ * @file
+ * @brief Contains the implementation of the h-table cache functions.
+ * The cache file of a map starts with a FileHeader, followed by a record for every stored point
+ * of interest: a RecordHeader and the distances of every cell from it, as in DistanceTable.
+ * New records are appended and the number of points of interest in the header is updated only
+ * after they are completely written. Values are stored with the endianness of the machine.
+ * @author Jacopo Zagoli
+ * @version 1.0
+ * @date November, 2022
+ * @copyright 2022 Jacopo Zagoli, Davide Furlani
+ */
+
+#include "distances/h_table_cache.h"
+
+#include <fcntl.h>
+#include <fmt/format.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <span>
+#include <stdexcept>
+#include <vector>
+
+#include "Point.h"
+#include "ambient/AmbientMapInstance.h"
+#include "custom_types.h"
+#include "distances/DistanceTable.h"
+
+namespace cmapd::h_table_cache {
+
+/// The first bytes of every cache file.
+constexpr std::array<char, 8> magic{'C', 'M', 'A', 'P', 'D', 'H', 'T', '\0'};
+/// The version of the file format, it must be changed every time the format changes.
+constexpr std::uint32_t version{1};
+
+/**
+ * @struct FileHeader
+ * @brief The header of a cache file.
+ */
+struct FileHeader {
+    /// Always equal to magic.
+    std::array<char, 8> magic;
+    /// The version of the file format.
+    std::uint32_t version;
+    /// The number of points of interest stored in the file.
+    std::uint32_t num_pois;
+    /// The number of rows of the map.
+    std::int32_t rows;
+    /// The number of columns of the map.
+    std::int32_t columns;
+    /// The hash of the map.
+    std::uint64_t map_hash;
+};
+
+/**
+ * @struct RecordHeader
+ * @brief The header of the record of a point of interest.
+ */
+struct RecordHeader {
+    /// The row of the point of interest.
+    std::int32_t row;
+    /// The column of the point of interest.
+    std::int32_t col;
+    /// The checksum of the distances of the record.
+    std::uint64_t checksum;
+};
+
+/**
+ * Computes a FNV-1a hash of some values, mixing a whole value at every step instead of a byte.
+ * @param values The values to be hashed.
+ * @param hash The hash of the previous values, if the hash is computed in more steps.
+ * @return the hash.
+ */
+template <typename T>
+std::uint64_t fnv1a(std::span<const T> values, std::uint64_t hash = 0xcbf29ce484222325ULL) {
+    for (T value : values) {
+        hash ^= static_cast<std::uint64_t>(value);
+        hash *= 0x100000001b3ULL;
+    }
+    return hash;
+}
+
+/**
+ * Get the size of a record of a map.
+ * @param num_cells The number of cells of the map.
+ * @return the size of a record, in bytes.
+ */
+std::size_t record_size(int num_cells) {
+    return sizeof(RecordHeader) + sizeof(int) * static_cast<std::size_t>(num_cells);
+}
+
+/**
+ * Checks if a header belongs to a valid cache file of a map.
+ * @param header The header read from the file.
+ * @param file_size The size of the file.
+ * @param hash The hash of the map.
+ * @param h_table An h-table with the shape of the map.
+ * @return true if the file is valid.
+ */
+bool is_valid(const FileHeader& header,
+              std::size_t file_size,
+              std::uint64_t hash,
+              const h_table_t& h_table) {
+    return header.magic == magic && header.version == version && header.map_hash == hash
+           && header.rows == h_table.rows_number() && header.columns == h_table.columns_number()
+           && file_size >= sizeof(FileHeader) + header.num_pois * record_size(h_table.num_cells());
+}
+
+std::uint64_t map_hash(const AmbientMapInstance& map_instance) {
+    const std::array<int, 2> shape{map_instance.rows_number(), map_instance.columns_number()};
+    std::vector<std::uint8_t> walls;
+    walls.reserve(static_cast<std::size_t>(shape[0]) * shape[1]);
+    for (int row = 0; row < shape[0]; ++row) {
+        for (int col = 0; col < shape[1]; ++col) {
+            walls.push_back(map_instance.is_passable({row, col}) ? 0 : 1);
+        }
+    }
+    return fnv1a<std::uint8_t>(walls, fnv1a<int>(shape));
+}
+
+std::filesystem::path cache_file(const std::filesystem::path& directory, std::uint64_t hash) {
+    return directory / fmt::format("{:016x}.htable", hash);
+}
+
+std::vector<bool> load(const std::filesystem::path& directory,
+                       std::uint64_t hash,
+                       h_table_t& h_table,
+                       const std::vector<bool>& filled) {
+    std::vector<bool> loaded(h_table.num_pois(), false);
+    const auto path{cache_file(directory, hash)};
+    const int fd{::open(path.c_str(), O_RDONLY)};
+    if (fd == -1) return loaded;
+    struct stat file_stat {};
+    if (::fstat(fd, &file_stat) == -1) {
+        ::close(fd);
+        return loaded;
+    }
+    const auto file_size{static_cast<std::size_t>(file_stat.st_size)};
+    if (file_size < sizeof(FileHeader)) {
+        ::close(fd);
+        std::filesystem::remove(path);
+        return loaded;
+    }
+    void* mapped{::mmap(nullptr, file_size, PROT_READ, MAP_PRIVATE, fd, 0)};
+    ::close(fd);
+    if (mapped == MAP_FAILED) return loaded;
+    const auto* bytes{static_cast<const std::byte*>(mapped)};
+
+    FileHeader header{};
+    std::memcpy(&header, bytes, sizeof(FileHeader));
+    bool corrupted{!is_valid(header, file_size, hash, h_table)};
+    const std::size_t column_bytes{sizeof(int) * static_cast<std::size_t>(h_table.num_cells())};
+    for (std::uint32_t i = 0; !corrupted && i < header.num_pois; ++i) {
+        const std::byte* record{bytes + sizeof(FileHeader) + i * record_size(h_table.num_cells())};
+        RecordHeader record_header{};
+        std::memcpy(&record_header, record, sizeof(RecordHeader));
+        if (record_header.row < 0 || record_header.row >= h_table.rows_number()
+            || record_header.col < 0 || record_header.col >= h_table.columns_number()) {
+            corrupted = true;
+            break;
+        }
+        const int poi{h_table.poi_index({record_header.row, record_header.col})};
+        if (poi == -1 || poi >= h_table.num_exact_pois() || loaded[poi]) continue;
+        if (filled[poi]) {
+            // the column doesn't need to be copied, but it doesn't need to be stored either
+            loaded[poi] = true;
+            continue;
+        }
+        const auto column{h_table.column(poi)};
+        std::memcpy(column.data(), record + sizeof(RecordHeader), column_bytes);
+        if (fnv1a<int>(column) == record_header.checksum) {
+            loaded[poi] = true;
+        } else {
+            std::fill(column.begin(), column.end(), DistanceTable::unreachable);
+            corrupted = true;
+        }
+    }
+    ::munmap(mapped, file_size);
+    // a corrupted file is rebuilt by the next store, loaded columns passed their checksum
+    if (corrupted) std::filesystem::remove(path);
+    return loaded;
+}
+
+/**
+ * Writes the record of a point of interest.
+ * @param file The stream on which the record is written.
+ * @param h_table The h-table containing the point of interest.
+ * @param poi The index of the point of interest.
+ */
+void write_record(std::ostream& file, const h_table_t& h_table, int poi) {
+    const auto distances{std::as_bytes(h_table.column(poi))};
+    const Point point{h_table.pois()[poi]};
+    const RecordHeader record_header{
+        .row = point.row, .col = point.col, .checksum = fnv1a<int>(h_table.column(poi))};
+    file.write(reinterpret_cast<const char*>(&record_header), sizeof(RecordHeader));
+    file.write(reinterpret_cast<const char*>(distances.data()),
+               static_cast<std::streamsize>(distances.size()));
+}
+
+void store(const std::filesystem::path& directory,
+           std::uint64_t hash,
+           const h_table_t& h_table,
+           const std::vector<bool>& loaded) {
+    const auto path{cache_file(directory, hash)};
+    std::fstream file{path, std::ios::in | std::ios::out | std::ios::binary};
+    FileHeader header{};
+    if (file && file.read(reinterpret_cast<char*>(&header), sizeof(FileHeader))
+        && is_valid(header, std::filesystem::file_size(path), hash, h_table)) {
+        // append the new columns, the records after the last complete one are overwritten
+        file.seekp(static_cast<std::streamoff>(sizeof(FileHeader)
+                                               + header.num_pois
+                                                     * record_size(h_table.num_cells())));
+        for (int poi = 0; poi < h_table.num_exact_pois(); ++poi) {
+            if (!loaded[poi]) {
+                write_record(file, h_table, poi);
+                ++header.num_pois;
+            }
+        }
+        file.flush();
+        file.seekp(0);
+        file.write(reinterpret_cast<const char*>(&header), sizeof(FileHeader));
+    } else {
+        // rebuild the file from scratch, replacing it only once it is complete
+        file.close();
+        std::filesystem::create_directories(directory);
+        auto temp_path{path};
+        temp_path += fmt::format(".{}.tmp", ::getpid());
+        std::ofstream temp_file{temp_path, std::ios::binary | std::ios::trunc};
+        header = {.magic = magic,
+                  .version = version,
+                  .num_pois = static_cast<std::uint32_t>(h_table.num_exact_pois()),
+                  .rows = h_table.rows_number(),
+                  .columns = h_table.columns_number(),
+                  .map_hash = hash};
+        temp_file.write(reinterpret_cast<const char*>(&header), sizeof(FileHeader));
+        for (int poi = 0; poi < h_table.num_exact_pois(); ++poi) {
+            write_record(temp_file, h_table, poi);
+        }
+        temp_file.close();
+        if (!temp_file) {
+            std::filesystem::remove(temp_path);
+            throw std::runtime_error{
+                fmt::format("{}: can't write the h-table cache", path.string())};
+        }
+        std::filesystem::rename(temp_path, path);
+        return;
+    }
+    if (!file) {
+        throw std::runtime_error{fmt::format("{}: can't write the h-table cache", path.string())};
+    }
+}
+
+}  // namespace cmapd::h_table_cache
@@ -0,0 +1,65 @@
+/**
+ * @file
+ * @brief Contains the functions used to store h-table columns on disk and load them back.
+ * @author Jacopo Zagoli
+ * @version 1.0
+ * @date November, 2022
+ * @copyright 2022 Jacopo Zagoli, Davide Furlani
+ */
+
+#pragma once
+#include <cstdint>
+#include <filesystem>
+#include <vector>
+
+#include "ambient/AmbientMapInstance.h"
+#include "custom_types.h"
+
+namespace cmapd::h_table_cache {
+
+/**
+ * Computes a hash of the walls of a map, which identifies the cache file of the map.
+ * @param map_instance The instance whose map is hashed.
+ * @return the hash of the map.
+ */
+[[nodiscard]] std::uint64_t map_hash(const AmbientMapInstance& map_instance);
+
+/**
+ * Get the path of the cache file of a map.
+ * @param directory The directory containing the cache files.
+ * @param hash The hash of the map.
+ * @return the path of the cache file.
+ */
+[[nodiscard]] std::filesystem::path cache_file(const std::filesystem::path& directory,
+                                               std::uint64_t hash);
+
+/**
+ * Fills the columns of the h-table of the points of interest found in the cache file of the map,
+ * except the ones already filled. The file is memory-mapped. If it is stale or corrupted it is
+ * deleted, so that the next store rebuilds it.
+ * @param directory The directory containing the cache files.
+ * @param hash The hash of the map, computed with map_hash.
+ * @param h_table The h-table to be filled, with the shape of the map.
+ * @param filled For every point of interest of the h-table, if its column is already filled.
+ * @return for every point of interest of the h-table, if its column is in the cache file.
+ */
+[[nodiscard]] std::vector<bool> load(const std::filesystem::path& directory,
+                                     std::uint64_t hash,
+                                     h_table_t& h_table,
+                                     const std::vector<bool>& filled);
+
+/**
+ * Adds to the cache file of the map the columns of the h-table that aren't in it yet. If
+ * the file doesn't exist or is not valid, it is rewritten with all the columns of the h-table.
+ * @param directory The directory containing the cache files, it is created if needed.
+ * @param hash The hash of the map, computed with map_hash.
+ * @param h_table The h-table whose columns are stored.
+ * @param loaded For every point of interest of the h-table, if its column is in the cache file.
+ * @throws runtime_error if the cache file can't be written.
+ */
+void store(const std::filesystem::path& directory,
+           std::uint64_t hash,
+           const h_table_t& h_table,
+           const std::vector<bool>& loaded);
+
+}  // namespace cmapd::h_table_cache
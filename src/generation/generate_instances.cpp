@@ -12,34 +12,35 @@
 #include <fmt/format.h>
 
 #include <filesystem>
-#include <fstream>
 #include <random>
+#include <utility>
 #include <vector>
 
 #include "Point.h"
 #include "ambient/AmbientMap.h"
-#include "ambient/AmbientMapInstance.h"
+#include "ambient/InstanceFormat.h"
+#include "ambient/instance_io.h"
 
 namespace cmapd {
 
-std::vector<AmbientMapInstance> generate_instances(const AmbientMap& map,
-                                                   const std::filesystem::path& save_path,
-                                                   int n_instances,
-                                                   int n_agents,
-                                                   int n_tasks) {
+std::vector<InstanceContents> generate_instances(const AmbientMap& map,
+                                                 const std::filesystem::path& save_path,
+                                                 int n_instances,
+                                                 int n_agents,
+                                                 int n_tasks,
+                                                 InstanceFormat format) {
     if (n_instances <= 0) {
         throw std::runtime_error("Number of instances to generate must be grater than zero");
     }
 
     std::vector<Point> agents{};
     std::vector<std::pair<Point, Point>> tasks{};
-    std::vector<AmbientMapInstance> instances{};
+    std::vector<InstanceContents> instances{};
 
     std::vector<Point> possible_positions{};
-    auto grid = map.map();
-    for (int i = 0; i < static_cast<int>(grid.size()); i++) {
-        for (int j = 0; j < static_cast<int>(grid[i].size()); j++) {
-            if (grid[i][j] == 'O') possible_positions.emplace_back(i, j);
+    for (int i = 0; i < map.rows_number(); i++) {
+        for (int j = 0; j < map.columns_number(); j++) {
+            if (map.is_valid({i, j})) possible_positions.emplace_back(i, j);
         }
     }
 
@@ -77,21 +78,13 @@ std::vector<AmbientMapInstance> generate_instances(const AmbientMap& map,
 
             tasks.emplace_back(the_chosen_start, the_chosen_end);
         }
-        instances.emplace_back(map, agents, tasks);
-
-        std::string file_name = fmt::format("instance_{}.txt", i);
+        std::string file_name = fmt::format(
+            "instance_{}.{}", i, format == InstanceFormat::BINARY ? "bin" : "txt");
         std::filesystem::path absolute_path = absolute(std::filesystem::path(save_path));
         std::filesystem::create_directory(absolute_path);
 
-        std::ofstream out_file{absolute_path.string() + "/" + file_name};
-
-        out_file << agents.size() << " " << tasks.size() << std::endl;
-        for (Point a : agents) out_file << a.row << " " << a.col << std::endl;
-        for (std::pair<Point, Point> t : tasks)
-            out_file << t.first.row << " " << t.first.col << " " << t.second.row << " "
-                     << t.second.col << std::endl;
-
-        out_file.close();
+        instances.push_back({std::move(agents), std::move(tasks)});
+        save_instance(map, instances.back(), absolute_path / file_name, format);
         agents.clear();
         tasks.clear();
     }
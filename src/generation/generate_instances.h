@@ -9,24 +9,29 @@
 
 #pragma once
 #include <ambient/AmbientMap.h>
-#include <ambient/AmbientMapInstance.h>
+#include <ambient/InstanceFormat.h>
+#include <ambient/instance_io.h>
 
 #include <filesystem>
 #include <vector>
 
 namespace cmapd {
 /**
- * Randomly generates a vector of AmbientMapInstance from a given AmbientMap
+ * Randomly generates the agents and the tasks of some instances of a given AmbientMap. The
+ * distances are not computed: an instance can be solved by building an AmbientMapInstance from
+ * the map and its agents and tasks
  * @param map AmbientMap reference on which generate instances
  * @param save_path path to a directory where to save all generated instances
  * @param n_instances number of instances to generate
  * @param n_agents number of agents on the map
  * @param n_tasks number of task on the map
- * @return a vector of AmbientMapInstance to solve
+ * @param format the format of the saved instances, instance_N.txt or instance_N.bin
+ * @return the agents and the tasks of every instance
  */
-std::vector<AmbientMapInstance> generate_instances(const AmbientMap& map,
-                                                   const std::filesystem::path& save_path,
-                                                   int n_instances,
-                                                   int n_agents,
-                                                   int n_tasks);
+std::vector<InstanceContents> generate_instances(const AmbientMap& map,
+                                                 const std::filesystem::path& save_path,
+                                                 int n_instances,
+                                                 int n_agents,
+                                                 int n_tasks,
+                                                 InstanceFormat format = InstanceFormat::TEXT);
 }
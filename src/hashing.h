@@ -0,0 +1,52 @@
+/**
+ * @file
+ * @brief Contains the functions used to pack and hash the keys of the hash tables.
+ * @author Jacopo Zagoli
+ * @version 1.0
+ * @date November, 2022
+ * @copyright 2022 Jacopo Zagoli, Davide Furlani
+ */
+
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+
+#include "Point.h"
+
+namespace cmapd {
+
+/**
+ * Packs two integers in 64 bits, the first one in the upper 32 bits.
+ * @param high The first integer.
+ * @param low The second integer.
+ * @return the packed integers, distinct for distinct pairs.
+ */
+[[nodiscard]] constexpr std::uint64_t pack_pair(int high, int low) {
+    return static_cast<std::uint64_t>(static_cast<std::uint32_t>(high)) << 32
+           | static_cast<std::uint32_t>(low);
+}
+
+/**
+ * Packs a cell in 64 bits, see pack_pair.
+ * @param cell The cell.
+ * @return the packed row and column of cell.
+ */
+[[nodiscard]] inline std::uint64_t pack_point(Point cell) {
+    return pack_pair(cell.row, cell.col);
+}
+
+/**
+ * Get the hash of a key at a timestep. The timestep is multiplied by the golden ratio, so that
+ * the consecutive timesteps of the same key spread over all the bits.
+ * @param key A packed key, like a cell or a move.
+ * @param timestep The timestep.
+ * @return the hash of the pair.
+ */
+[[nodiscard]] inline std::size_t hash_at_timestep(std::uint64_t key, int timestep) {
+    return std::hash<std::uint64_t>{}(key
+                                      ^ static_cast<std::uint32_t>(timestep)
+                                            * 0x9E3779B97F4A7C15ULL);
+}
+
+}  // namespace cmapd
@@ -10,16 +10,27 @@
 #include <fmt/format.h>
 
 #include <argparse/argparse.hpp>
+#include <cstddef>
 #include <filesystem>
+#include <fstream>
+#include <memory>
 #include <regex>
+#include <sstream>
 #include <string>
 
 #include "CmapdSolution.h"
 #include "Timer.hpp"
+#include "a_star/Planner.h"
 #include "ambient/AmbientMap.h"
+#include "ambient/InstanceFormat.h"
+#include "ambient/instance_io.h"
 #include "custom_types.h"
+#include "distances/DistanceKernel.h"
+#include "distances/DistanceOracle.h"
+#include "distances/DistancesConfig.h"
 #include "generation/generate_instances.h"
 #include "ortools/ortools.h"
+#include "path_finders/ConflictDetector.h"
 #include "path_finders/cbs.h"
 #include "path_finders/pp.h"
 
@@ -29,11 +40,31 @@
  * @param map_path The path to the map.
  * @param capacity The capacity of the agents.
  * @param solver The solver type, CBS or PBS.
+ * @param planner The algorithm used by the solver to find the path of a single agent.
+ * @param distances_config The options used to compute the h-tables.
+ * @param distances_memory The memory budget, in bytes, of the distances shared by the instances.
+ * @param solutions_path The directory where the binary solutions are saved, or an empty path if
+ * they are only printed.
  */
 void solver(const std::filesystem::path& instances_path,
             const std::filesystem::path& map_path,
             int capacity,
-            std::string_view solver);
+            std::string_view solver,
+            cmapd::Planner planner,
+            const cmapd::DistancesConfig& distances_config,
+            std::size_t distances_memory,
+            const std::filesystem::path& solutions_path);
+
+/**
+ * Converts an instance between the text and the binary formats, or a binary solution to text.
+ * @param map_path The path to the map of the instance.
+ * @param input_path The instance or the solution (.sol) to be converted.
+ * @param output_path The converted file. Instances are saved in the binary format if its
+ * extension is .bin, in the text format otherwise.
+ */
+void convert(const std::filesystem::path& map_path,
+             const std::filesystem::path& input_path,
+             const std::filesystem::path& output_path);
 
 /**
  * @brief The program entry point.
@@ -42,11 +73,15 @@ int main(int argc, char* argv[]) {
     using namespace std::string_literals;
     argparse::ArgumentParser parser{"cmapd"};
     parser.add_description("Capacitated Multi Agent Pickup and Delivery solver.");
-    parser.add_epilog("You must provide at least one option between generate or evaluate.");
+    parser.add_epilog(
+        "You must provide at least one option between generate or evaluate, or the convert "
+        "command.");
 
     // --- Arguments to parse ---
     parser.add_argument("map_path")
-        .help("The path pointing to the map file. For example, /home/map.txt");
+        .help(
+            "The path pointing to the map file, or to a MovingAI map. For example, "
+            "/home/map.txt");
 
     parser.add_argument("-g", "--generate")
         .help(
@@ -75,10 +110,15 @@ int main(int argc, char* argv[]) {
         .metavar("OUT_PATH")
         .default_value("output"s);
 
+    parser.add_argument("--binary")
+        .help("Flag used to save the generated instances in the binary format.")
+        .implicit_value(true)
+        .default_value(false);
+
     parser.add_argument("-e", "--evaluate")
         .help(
             "Specify the path pointing to a directory containing the generated instances "
-            "and evaluate them.")
+            "(or MovingAI scenarios, .scen) and evaluate them.")
         .metavar("INSTANCES_PATH");
 
     parser.add_argument("-c", "--capacity")
@@ -94,6 +134,74 @@ int main(int argc, char* argv[]) {
         .metavar("SOLVER")
         .default_value("CBS"s);
 
+    parser.add_argument("-p", "--planner")
+        .help(
+            "Specify the algorithm used by the solver to find the path of a single agent. Could be "
+            "A_STAR or SIPP.")
+        .metavar("PLANNER")
+        .default_value("A_STAR"s);
+
+    parser.add_argument("-t", "--threads")
+        .help(
+            "The number of threads used to compute the distances when evaluating the instances. "
+            "If zero, the number of hardware threads is used.")
+        .metavar("THREADS")
+        .default_value(0)
+        .scan<'i', int>();
+
+    parser.add_argument("-k", "--kernel")
+        .help(
+            "Specify the algorithm used to compute the distances when evaluating the instances. "
+            "Could be SCALAR or LAZY.")
+        .metavar("KERNEL")
+        .default_value("SCALAR"s);
+
+    parser.add_argument("--distances-cache")
+        .help(
+            "Specify a directory where the distances computed when evaluating the instances are "
+            "saved, so that following evaluations on the same map can load them.")
+        .metavar("CACHE_PATH");
+
+    parser.add_argument("--distances-memory")
+        .help(
+            "The maximum memory, in MiB, used to keep the distances computed for an instance, so "
+            "that the following instances on the same map don't compute them again. If zero, the "
+            "distances are not kept.")
+        .metavar("MEMORY")
+        .default_value(0)
+        .scan<'i', int>();
+
+    parser.add_argument("--h-table-memory")
+        .help(
+            "The maximum memory, in MiB, used by the distances of an instance. The distances from "
+            "the points of interest that don't fit are estimated using landmarks. If zero, there "
+            "is no limit.")
+        .metavar("MEMORY")
+        .default_value(0)
+        .scan<'i', int>();
+
+    parser.add_argument("--landmarks")
+        .help("The number of landmarks used to estimate the distances that don't fit in memory.")
+        .metavar("LANDMARKS")
+        .default_value(16)
+        .scan<'i', int>();
+
+    parser.add_argument("--solutions-output")
+        .help(
+            "Specify a directory where the solutions of the evaluated instances are saved, in the "
+            "binary format.")
+        .metavar("SOLUTIONS_PATH");
+
+    argparse::ArgumentParser convert_command{"convert"};
+    convert_command.add_description(
+        "Converts an instance of the map between the text and the binary formats, or prints a "
+        "binary solution (.sol) as text.");
+    convert_command.add_argument("input").help("The instance or the solution to be converted.");
+    convert_command.add_argument("output").help(
+        "The converted file. Instances are saved in the binary format if its extension is .bin, "
+        "in the text format otherwise.");
+    parser.add_subparser(convert_command);
+
     // --- Parsing arguments ---
     try {
         parser.parse_args(argc, argv);
@@ -104,6 +212,17 @@ int main(int argc, char* argv[]) {
     }
 
     // --- Handling arguments ---
+    if (parser.is_subcommand_used("convert")) {
+        try {
+            convert(std::filesystem::path{parser.get("map_path")},
+                    std::filesystem::path{convert_command.get("input")},
+                    std::filesystem::path{convert_command.get("output")});
+        } catch (const std::exception& ex) {
+            std::cerr << ex.what() << "\n";
+            std::exit(EXIT_FAILURE);
+        }
+        return 0;
+    }
     if (parser["--generate"] == false && !parser.present("--evaluate")) {
         std::cerr << "You must provide at least one option between generate or evaluate!\n";
         std::exit(EXIT_FAILURE);
@@ -130,7 +249,9 @@ int main(int argc, char* argv[]) {
                                       instances_out_path,
                                       n_instances_opt.value(),
                                       n_agents_opt.value(),
-                                      n_tasks_opt.value());
+                                      n_tasks_opt.value(),
+                                      parser["--binary"] == true ? cmapd::InstanceFormat::BINARY
+                                                                 : cmapd::InstanceFormat::TEXT);
             std::cout << "Done." << std::endl;
         } else {
             std::cerr << "If you want to generate instances, you must provide the number "
@@ -143,13 +264,57 @@ int main(int argc, char* argv[]) {
         auto instances_in_path = std::filesystem::path{instances_in_path_opt.value()};
         const std::string& solver_type = parser.get("--solver");
         const int capacity = parser.get<int>("--capacity");
+        cmapd::DistancesConfig distances_config{.threads = parser.get<int>("--threads")};
+        if (auto cache_path_opt = parser.present("--distances-cache")) {
+            distances_config.cache_directory = cache_path_opt.value();
+        }
+        if (distances_config.threads < 0) {
+            std::cerr << "The number of threads can't be negative!\n";
+            std::exit(EXIT_FAILURE);
+        }
+        const int distances_memory = parser.get<int>("--distances-memory");
+        const int h_table_memory = parser.get<int>("--h-table-memory");
+        if (distances_memory < 0 || h_table_memory < 0) {
+            std::cerr << "The memory used to keep the distances can't be negative!\n";
+            std::exit(EXIT_FAILURE);
+        }
+        distances_config.memory_budget = static_cast<std::size_t>(h_table_memory) << 20;
+        distances_config.landmarks = parser.get<int>("--landmarks");
+        if (distances_config.memory_budget > 0 && distances_config.landmarks < 1) {
+            std::cerr << "The number of landmarks must be positive with --h-table-memory!\n";
+            std::exit(EXIT_FAILURE);
+        }
+        if (const std::string& kernel = parser.get("--kernel"); kernel == "LAZY") {
+            distances_config.kernel = cmapd::DistanceKernel::LAZY;
+        } else if (kernel != "SCALAR") {
+            std::cerr << kernel
+                      << " is not a known kernel. Possible kernels are: SCALAR, LAZY (case "
+                         "sensitive).\n";
+            std::exit(EXIT_FAILURE);
+        }
+        cmapd::Planner planner{cmapd::Planner::A_STAR};
+        if (const std::string& planner_type = parser.get("--planner"); planner_type == "SIPP") {
+            planner = cmapd::Planner::SIPP;
+        } else if (planner_type != "A_STAR") {
+            std::cerr << planner_type
+                      << " is not a known planner. Possible planners are: A_STAR, SIPP (case "
+                         "sensitive).\n";
+            std::exit(EXIT_FAILURE);
+        }
         if (solver_type == "CBS" || solver_type == "PP") {
             std::cout << fmt::format(
                 "Solving instances in {}, capacity set to {} with {} solver.\n",
                 instances_in_path.string(),
                 capacity,
                 solver_type);
-            solver(instances_in_path, map_path, capacity, solver_type);
+            solver(instances_in_path,
+                   map_path,
+                   capacity,
+                   solver_type,
+                   planner,
+                   distances_config,
+                   static_cast<std::size_t>(distances_memory) << 20,
+                   std::filesystem::path{parser.present("--solutions-output").value_or("")});
         } else {
             std::cerr << solver_type
                       << " is not a known solver. Possible solvers are: CBS, PP (case "
@@ -162,41 +327,67 @@ int main(int argc, char* argv[]) {
 }
 
 /**
- * Prints a solution.
- * @param solution The solution to be printed.
+ * Formats a solution as text: the path of every agent, then the makespan and the cost.
+ * @param solution The solution to be formatted.
+ * @param style The style of the makespan and the cost.
+ * @return the formatted solution.
  */
-void print_solution(const cmapd::CmapdSolution& solution) {
+std::string format_solution(const cmapd::CmapdSolution& solution, fmt::text_style style = {}) {
+    std::ostringstream text;
     for (int i = 0; i < std::ssize(solution.paths); ++i) {
-        std::cout << "Agent " << i << ": [";
+        text << "Agent " << i << ": [";
         const char* padding = "";
         for (const auto& point : solution.paths[i]) {
-            std::cout << padding << point;
+            text << padding << point;
             padding = ", ";
         }
-        std::cout << "]" << std::endl;
+        text << "]\n";
     }
-    fmt::print(
-        fmt::emphasis::bold, "makespan:{:6}\ncost:{:10}\n", solution.makespan, solution.cost);
+    text << fmt::format(style, "makespan:{:6}\ncost:{:10}\n", solution.makespan, solution.cost);
+    if (solution.expanded_nodes > 0) {
+        text << fmt::format("expanded nodes:{:6}\n", solution.expanded_nodes);
+    }
+    return text.str();
+}
+
+/**
+ * Prints a solution.
+ * @param solution The solution to be printed.
+ */
+void print_solution(const cmapd::CmapdSolution& solution) {
+    fmt::print("{}", format_solution(solution, fmt::emphasis::bold));
 }
 
 void solver(const std::filesystem::path& instances_path,
             const std::filesystem::path& map_path,
             int capacity,
-            std::string_view solver) {
+            std::string_view solver,
+            cmapd::Planner planner,
+            const cmapd::DistancesConfig& distances_config,
+            std::size_t distances_memory,
+            const std::filesystem::path& solutions_path) {
     using namespace cmapd;
     using namespace timer;
 
+    // the map is loaded once and shared by all the instances
+    const auto map{std::make_shared<const AmbientMap>(map_path)};
+    // the distances computed for an instance are reused by the following ones
+    DistanceOracle oracle{*map, distances_memory};
+    DistancesConfig instance_config{distances_config};
+    if (distances_memory > 0) instance_config.oracle = &oracle;
+
     Timer<HOST, seconds> T_HT;
     Timer<HOST, seconds> T_TA;
     Timer<HOST, seconds> T_PF;
 
+    if (!solutions_path.empty()) std::filesystem::create_directories(solutions_path);
     for (const auto& entry : std::filesystem::directory_iterator(instances_path)) {
         const auto filename = entry.path().filename().string();
-        if (std::regex_match(filename, std::regex{"instance_[0-9]+\\.txt"})) {
+        if (std::regex_match(filename, std::regex{"instance_[0-9]+\\.(txt|bin)|.*\\.scen"})) {
             fmt::print(fmt::fg(fmt::color::light_green), "\nSolving {}\n", filename);
             try {
                 T_HT.start();
-                AmbientMapInstance instance{entry.path(), map_path};
+                AmbientMapInstance instance{map, entry.path(), instance_config};
                 T_HT.stop();
 
                 // Task assignment
@@ -208,18 +399,35 @@ void solver(const std::filesystem::path& instances_path,
                 CmapdSolution solution;
                 T_PF.start();
                 if (solver == "CBS") {
-                    solution = cbs::cbs(instance, goal_sequences);
+                    solution = cbs::cbs(instance, goal_sequences, planner);
                 } else if (solver == "PP") {
-                    solution = pp::pp(instance, goal_sequences);
+                    solution = pp::pp(instance, goal_sequences, planner);
                 }
                 T_PF.stop();
                 print_solution(solution);
+                // the agents stay in the last cells of their paths, where they can collide too
+                if (const ConflictDetector detector{solution.paths};
+                    const auto conflict = detector.first_conflict()) {
+                    fmt::print(fmt::fg(fmt::color::orange_red),
+                               "The solution has {} pairs of agents in conflict, the first "
+                               "ones are {} and {} at timestep {}.\n",
+                               detector.num_conflicts(),
+                               conflict->first_agent,
+                               conflict->second_agent,
+                               conflict->timestep);
+                }
+                if (!solutions_path.empty()) {
+                    auto solution_name{entry.path().filename().replace_extension(".sol")};
+                    save_solution(solution, solutions_path / solution_name);
+                }
 
                 fmt::print(fmt::emphasis::bold,
                            "H-table computing time:{:20}'\n"
+                           "H-table memory:{:24.1f} MiB\n"
                            "Task assignment time:{:22}'\n"
                            "Path finding time:{:25}'\n",
                            T_HT.duration(),
+                           static_cast<double>(instance.h_table().memory_usage()) / (1 << 20),
                            T_TA.duration(),
                            T_PF.duration());
 
@@ -235,4 +443,24 @@ void solver(const std::filesystem::path& instances_path,
                "\nTOTAL TIME:{:20} seconds\nMEAN TIME:{:21} seconds\n",
                total_time,
                avg_time);
-}
\ No newline at end of file
+}
+
+void convert(const std::filesystem::path& map_path,
+             const std::filesystem::path& input_path,
+             const std::filesystem::path& output_path) {
+    using namespace cmapd;
+
+    if (input_path.extension() == ".sol") {
+        const CmapdSolution solution{load_solution(input_path)};
+        std::ofstream out_file{output_path};
+        out_file << format_solution(solution);
+        if (!out_file) {
+            throw std::runtime_error{fmt::format("{}: can't write the file", output_path.string())};
+        }
+        return;
+    }
+    const AmbientMap map{map_path};
+    const auto format{output_path.extension() == ".bin" ? InstanceFormat::BINARY
+                                                        : InstanceFormat::TEXT};
+    save_instance(map, load_instance(input_path, map), output_path, format);
+}
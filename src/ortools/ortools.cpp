@@ -10,6 +10,8 @@
 
 #include "ortools.h"
 
+#include <stdexcept>
+#include <string>
 #include <vector>
 
 #include "Point.h"
@@ -42,24 +44,22 @@ std::vector<path_t> assign_tasks(const AmbientMapInstance& instance, int capacit
                                                      depot};
 
     // In the OR-Tools library, Nodes and indices don't correspond to real point on the map.
-    // Therefore, we need to associate nodes with their real location.
+    // Therefore, we need to associate nodes with their real location. The same point can belong to
+    // more nodes (e.g. a task starting where an agent is), so nodes are never looked up by point:
+    // the task i has its pickup at the node num_agents + 2i and its delivery at the next one.
     std::map<RoutingIndexManager::NodeIndex, Point> node_to_point{};
-    std::map<Point, RoutingIndexManager::NodeIndex> point_to_node{};
     int counter = 0;
     // Can't use square brackets syntax for node_to_point since Point doesn't have default
     // constructor
     for (const auto& agent : instance.agents()) {
         node_to_point.emplace(RoutingIndexManager::NodeIndex{counter}, agent);
-        point_to_node.emplace(agent, RoutingIndexManager::NodeIndex{counter});
         ++counter;
     }
     for (const auto& [start, end] : instance.tasks()) {
         node_to_point.emplace(RoutingIndexManager::NodeIndex{counter}, start);
-        point_to_node.emplace(start, RoutingIndexManager::NodeIndex{counter});
         ++counter;
 
         node_to_point.emplace(RoutingIndexManager::NodeIndex{counter}, end);
-        point_to_node.emplace(end, RoutingIndexManager::NodeIndex{counter});
         ++counter;
     }
 
@@ -96,7 +96,15 @@ std::vector<path_t> assign_tasks(const AmbientMapInstance& instance, int capacit
         }
         auto from_point = node_to_point.at(from_node);
         auto to_point = node_to_point.at(to_node);
-        return instance.h_table().at(from_point).at(to_point);
+        const int distance{instance.h_table().distance(from_point, to_point)};
+        // a negative arc cost would be taken as a shortcut, the instance can't be solved
+        if (distance == h_table_t::unreachable) {
+            throw std::out_of_range{"(" + std::to_string(to_point.row) + ", "
+                                    + std::to_string(to_point.col) + ") can't be reached from ("
+                                    + std::to_string(from_point.row) + ", "
+                                    + std::to_string(from_point.col) + ")"};
+        }
+        return distance;
     };
 
     auto transit_callback_index{routing.RegisterTransitCallback(distance_callback)};
@@ -122,9 +130,10 @@ std::vector<path_t> assign_tasks(const AmbientMapInstance& instance, int capacit
 
     Solver* const solver = routing.solver();
 
-    for (const auto& [start, end] : instance.tasks()) {
-        int64_t pickup_index = manager.NodeToIndex(point_to_node.at(start));
-        int64_t delivery_index = manager.NodeToIndex(point_to_node.at(end));
+    for (int i = 0; i < instance.num_tasks(); ++i) {
+        const RoutingIndexManager::NodeIndex pickup{instance.num_agents() + 2 * i};
+        int64_t pickup_index = manager.NodeToIndex(pickup);
+        int64_t delivery_index = manager.NodeToIndex(pickup + 1);
         routing.AddPickupAndDelivery(pickup_index, delivery_index);
         solver->AddConstraint(solver->MakeEquality(routing.VehicleVar(pickup_index),
                                                    routing.VehicleVar(delivery_index)));
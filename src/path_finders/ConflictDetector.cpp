@@ -0,0 +1,197 @@
+/**
+ * @file
+ * @brief Contains the implementation of the class ConflictDetector.
+ * @author Jacopo Zagoli
+ * @version 1.0
+ * @date November, 2022
+ * @copyright 2022 Jacopo Zagoli, Davide Furlani
+ */
+
+#include "path_finders/ConflictDetector.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <tuple>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "Conflict.h"
+#include "ConflictType.h"
+#include "Point.h"
+#include "custom_types.h"
+#include "hashing.h"
+
+namespace cmapd {
+
+std::size_t ConflictDetector::SpaceTimeHash::operator()(
+    const SpaceTime& space_time) const noexcept {
+    return hash_at_timestep(pack_point(space_time.cell), space_time.timestep);
+}
+
+int ConflictDetector::last_visit(Point cell, int timestep) const {
+    const auto it{m_last_visit.find({cell, timestep})};
+    return it == m_last_visit.cend() ? -1 : it->second;
+}
+
+ConflictDetector::ConflictDetector(const std::vector<path_t>& paths) {
+    for (const auto& path : paths) {
+        add_path(path);
+    }
+}
+
+void ConflictDetector::add_path(const path_t& path) {
+    const int agent{static_cast<int>(m_paths.size())};
+    m_paths.push_back(&path);
+    for (int timestep = 0; timestep < std::ssize(path); ++timestep) {
+        const int index{static_cast<int>(m_visits.size())};
+        const auto [it, inserted] = m_last_visit.try_emplace({path[timestep], timestep}, index);
+        m_visits.push_back({.agent = agent,
+                            .previous = path[timestep > 0 ? timestep - 1 : 0],
+                            .next = inserted ? -1 : it->second});
+        it->second = index;
+    }
+    if (!path.empty()) {
+        m_parkings[pack_point(path.back())].push_back(
+            {.agent = agent, .timestep = static_cast<int>(std::ssize(path)) - 1});
+    }
+}
+
+template <typename Report>
+void ConflictDetector::sweep(Report report) const {
+    for (int agent = 0; agent < std::ssize(m_paths); ++agent) {
+        const path_t& path{*m_paths[agent]};
+        for (int timestep = 0; timestep < std::ssize(path); ++timestep) {
+            const Point cell{path[timestep]};
+            // the agents in the same cell, each pair is reported by its second agent
+            for (int visit = last_visit(cell, timestep); visit != -1;
+                 visit = m_visits[visit].next) {
+                if (const int other{m_visits[visit].agent}; other < agent) {
+                    report(Conflict{other, agent, timestep, cell, cell, ConflictType::VERTEX});
+                }
+            }
+            // the agents which already reached the end of their paths in the cell
+            if (const auto it{m_parkings.find(pack_point(cell))}; it != m_parkings.cend()) {
+                for (const auto& parking : it->second) {
+                    if (parking.agent != agent && parking.timestep < timestep) {
+                        report(Conflict{std::min(agent, parking.agent),
+                                        std::max(agent, parking.agent),
+                                        timestep,
+                                        cell,
+                                        cell,
+                                        ConflictType::VERTEX});
+                    }
+                }
+            }
+            // the agents moving in the opposite direction
+            if (timestep == 0 || path[timestep - 1] == cell) continue;
+            const Point previous{path[timestep - 1]};
+            for (int visit = last_visit(previous, timestep); visit != -1;
+                 visit = m_visits[visit].next) {
+                const int other{m_visits[visit].agent};
+                if (other < agent && m_visits[visit].previous == cell) {
+                    report(Conflict{other, agent, timestep, cell, previous, ConflictType::EDGE});
+                }
+            }
+        }
+    }
+}
+
+/**
+ * Get the order in which the conflicts of a pair of agents are found comparing their paths
+ * timestep by timestep: an edge conflict is found while looking at the timestep before it, so it
+ * comes before a vertex conflict at the same timestep.
+ * @param conflict A conflict.
+ * @return the agents of the conflict, then its position in the scan of their paths.
+ */
+std::tuple<int, int, int> scan_order(const Conflict& conflict) {
+    return {conflict.first_agent,
+            conflict.second_agent,
+            2 * conflict.timestep - (conflict.type == ConflictType::EDGE ? 1 : 0)};
+}
+
+std::optional<Conflict> ConflictDetector::first_conflict() const {
+    std::optional<Conflict> first;
+    sweep([&first](const Conflict& conflict) {
+        if (!first || scan_order(conflict) < scan_order(first.value())) first = conflict;
+    });
+    return first;
+}
+
+std::vector<Conflict> ConflictDetector::pair_conflicts() const {
+    std::unordered_map<std::uint64_t, Conflict> firsts;
+    sweep([&firsts](const Conflict& conflict) {
+        const auto [it, inserted] = firsts.try_emplace(
+            pack_pair(conflict.first_agent, conflict.second_agent), conflict);
+        if (!inserted && scan_order(conflict) < scan_order(it->second)) it->second = conflict;
+    });
+    std::vector<Conflict> conflicts;
+    conflicts.reserve(firsts.size());
+    for (const auto& [pair, conflict] : firsts) {
+        conflicts.push_back(conflict);
+    }
+    std::sort(conflicts.begin(), conflicts.end(), [](const Conflict& lhs, const Conflict& rhs) {
+        return scan_order(lhs) < scan_order(rhs);
+    });
+    return conflicts;
+}
+
+std::vector<Conflict> ConflictDetector::conflicts() const {
+    std::vector<Conflict> conflicts;
+    sweep([&conflicts](const Conflict& conflict) { conflicts.push_back(conflict); });
+    std::stable_sort(conflicts.begin(),
+                     conflicts.end(),
+                     [](const Conflict& lhs, const Conflict& rhs) {
+                         return lhs.timestep < rhs.timestep;
+                     });
+    return conflicts;
+}
+
+int ConflictDetector::num_conflicts() const {
+    std::unordered_set<std::uint64_t> pairs;
+    sweep([&pairs](const Conflict& conflict) {
+        pairs.insert(pack_pair(conflict.first_agent, conflict.second_agent));
+    });
+    return static_cast<int>(pairs.size());
+}
+
+std::optional<Conflict> ConflictDetector::first_conflict(int first_agent,
+                                                         int second_agent,
+                                                         const path_t& first_path,
+                                                         const path_t& second_path) {
+    // the agents stay in the last cells of their paths
+    const auto position = [](const path_t& path, std::ptrdiff_t timestep) {
+        return path[std::min(timestep, std::ssize(path) - 1)];
+    };
+    const auto length{std::max(std::ssize(first_path), std::ssize(second_path))};
+    for (int timestep = 0; timestep < length; ++timestep) {
+        const Point first_position{position(first_path, timestep)};
+        const Point second_position{position(second_path, timestep)};
+        if (first_position == second_position) {
+            return Conflict{first_agent,
+                            second_agent,
+                            timestep,
+                            first_position,
+                            second_position,
+                            ConflictType::VERTEX};
+        }
+        if (timestep < length - 1) {
+            const Point first_next{position(first_path, timestep + 1)};
+            if (first_position == position(second_path, timestep + 1)
+                && second_position == first_next) {
+                return Conflict{first_agent,
+                                second_agent,
+                                timestep + 1,
+                                first_position,
+                                first_next,
+                                ConflictType::EDGE};
+            }
+        }
+    }
+    return {};
+}
+
+}  // namespace cmapd
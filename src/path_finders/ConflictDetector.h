@@ -0,0 +1,145 @@
+/**
+ * @file
+ * @brief Contains the class ConflictDetector.
+ * @author Jacopo Zagoli
+ * @version 1.0
+ * @date November, 2022
+ * @copyright 2022 Jacopo Zagoli, Davide Furlani
+ */
+
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <unordered_map>
+#include <vector>
+
+#include "Conflict.h"
+#include "Point.h"
+#include "custom_types.h"
+
+namespace cmapd {
+
+/**
+ * @class ConflictDetector
+ * @brief Finds the conflicts between the paths of the agents, sweeping every path once through a
+ * table of the agents in every cell at every timestep, instead of comparing every pair of paths.
+ * An agent stays in the last cell of its path after reaching it.
+ */
+class ConflictDetector {
+  private:
+    /**
+     * @struct Visit
+     * @brief An agent in a cell at a timestep.
+     */
+    struct Visit {
+        /// The agent.
+        int agent;
+        /// The cell of the agent in the previous timestep.
+        Point previous;
+        /// The index in m_visits of the following agent in the same cell at the same timestep, or
+        /// -1.
+        int next;
+    };
+    /**
+     * @struct Parking
+     * @brief An agent which stays in a cell after the end of its path.
+     */
+    struct Parking {
+        /// The agent.
+        int agent;
+        /// The last timestep of the path of the agent.
+        int timestep;
+    };
+
+    /**
+     * @struct SpaceTime
+     * @brief A cell at a timestep.
+     */
+    struct SpaceTime {
+        /// The cell.
+        Point cell;
+        /// The timestep.
+        int timestep;
+        /// Equality operator.
+        bool operator==(const SpaceTime& rhs) const = default;
+    };
+    /**
+     * @struct SpaceTimeHash
+     * @brief Hash function of a SpaceTime.
+     */
+    struct SpaceTimeHash {
+        /// Get the hash of a SpaceTime.
+        std::size_t operator()(const SpaceTime& space_time) const noexcept;
+    };
+
+    /// The paths, which must outlive the detector.
+    std::vector<const path_t*> m_paths;
+    /// The visits of all the cells at all the timesteps.
+    std::vector<Visit> m_visits;
+    /// For every cell and timestep, the index in m_visits of the last agent which was there.
+    std::unordered_map<SpaceTime, int, SpaceTimeHash> m_last_visit;
+    /// For every cell, packed by pack_point, the agents which stay there after the end of their
+    /// paths.
+    std::unordered_map<std::uint64_t, std::vector<Parking>> m_parkings;
+
+    /// Get the index in m_visits of the last agent in a cell at a timestep, or -1.
+    [[nodiscard]] int last_visit(Point cell, int timestep) const;
+    /**
+     * Call a function for every conflict, once for every timestep in which two agents are in the
+     * same cell or swap their cells.
+     * @param report The function, called with the conflict, whose first agent is the smaller.
+     */
+    template <typename Report>
+    void sweep(Report report) const;
+
+  public:
+    /// Constructs a detector without paths.
+    ConflictDetector() = default;
+    /**
+     * Constructs a detector with some paths.
+     * @param paths The paths of the agents, in order, which must outlive the detector.
+     */
+    explicit ConflictDetector(const std::vector<path_t>& paths);
+    /**
+     * Add the path of the next agent.
+     * @param path The path, which must outlive the detector.
+     */
+    void add_path(const path_t& path);
+    /**
+     * Get the first conflict: the earliest one of the first pair of agents in conflict, in the
+     * order of their indexes.
+     * @return the first conflict, if any.
+     */
+    [[nodiscard]] std::optional<Conflict> first_conflict() const;
+    /**
+     * Get the first conflict of every pair of agents in conflict.
+     * @return the conflicts, sorted by their agents.
+     */
+    [[nodiscard]] std::vector<Conflict> pair_conflicts() const;
+    /**
+     * Get all the conflicts, sorted by timestep.
+     * @return the conflicts.
+     */
+    [[nodiscard]] std::vector<Conflict> conflicts() const;
+    /**
+     * Get the number of pairs of agents in conflict.
+     * @return the number of pairs of agents with at least a conflict.
+     */
+    [[nodiscard]] int num_conflicts() const;
+    /**
+     * Get the first conflict between two paths, comparing them timestep by timestep. It's the
+     * conflict between the two agents which first_conflict would find.
+     * @param first_agent The first agent, smaller than the second one.
+     * @param second_agent The second agent.
+     * @param first_path The path of the first agent.
+     * @param second_path The path of the second agent.
+     * @return the first conflict, if any.
+     */
+    [[nodiscard]] static std::optional<Conflict> first_conflict(int first_agent,
+                                                                int second_agent,
+                                                                const path_t& first_path,
+                                                                const path_t& second_path);
+};
+
+}  // namespace cmapd
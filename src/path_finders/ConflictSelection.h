@@ -0,0 +1,25 @@
+/**
+ * @file
+ * @brief Contains the ConflictSelection enum.
+ * @author Jacopo Zagoli
+ * @version 1.0
+ * @date November, 2022
+ * @copyright 2022 Jacopo Zagoli, Davide Furlani
+ */
+
+#pragma once
+
+namespace cmapd::cbs {
+
+/**
+ * @enum ConflictSelection
+ * @brief Describes how cbs chooses the conflict on which a node is split.
+ */
+enum class ConflictSelection {
+    /// The earliest conflict of the first pair of agents in conflict.
+    FIRST,
+    /// A cardinal conflict if any, otherwise a semi-cardinal one, otherwise the first conflict.
+    CARDINAL
+};
+
+}  // namespace cmapd::cbs
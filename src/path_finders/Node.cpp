@@ -9,49 +9,50 @@
 
 #include "path_finders/Node.h"
 
+#include <algorithm>
 #include <limits>
+#include <map>
+#include <memory>
 #include <optional>
-#include <stdexcept>
+#include <utility>
 #include <vector>
 
 #include "Conflict.h"
+#include "ConflictCardinality.h"
 #include "ConflictType.h"
 #include "Constraint.h"
 #include "Point.h"
+#include "a_star/Mdd.h"
+#include "a_star/Planner.h"
 #include "a_star/multi_a_star.h"
 #include "ambient/AmbientMapInstance.h"
 #include "custom_types.h"
+#include "path_finders/ConflictDetector.h"
 
 namespace cmapd::cbs {
 
-/**
- * Get a Point in a path at a given timestamp.
- * @param path The path to be analyzed.
- * @param timestep The timestep at which we request a Point.
- * @return the Point at the given timestep. If the timestep is longer than the path, returns the
- * last point.
- */
-Point get_position(const path_t& path, int timestep) {
-    if (timestep < 0) {
-        throw std::invalid_argument{"timestep must be greater than zero."};
-    }
-    if (timestep < std::ssize(path)) {
-        return path.at(timestep);
-    } else {
-        return path.back();
-    }
-}
-
 Node::Node(const AmbientMapInstance& instance,
            std::vector<path_t> goal_sequences,
-           std::vector<Constraint>&& constraints)
-    : m_constraints{std::move(constraints)} {
+           std::vector<Constraint>&& constraints,
+           Planner planner)
+    : m_constraints{std::make_shared<const ConstraintChain>(
+        ConstraintChain{.constraints = std::move(constraints), .parent = nullptr})} {
     for (int i = 0; i < std::ssize(goal_sequences); ++i) {
         auto start_location = goal_sequences.at(i).at(0);
         // remove start location from goal_sequence
         goal_sequences.at(i).erase(goal_sequences.at(i).cbegin());
-        m_paths.push_back(cmapd::multi_a_star::multi_a_star(
-            i, start_location, goal_sequences.at(i), instance, m_constraints));
+        m_paths.push_back(std::make_shared<const path_t>(cmapd::multi_a_star::find_path(
+            planner, i, start_location, goal_sequences.at(i), instance, agent_constraints(i))));
+        m_cost += static_cast<int>(std::ssize(*m_paths.back()));
+    }
+    m_mdds.resize(m_paths.size());
+    // the conflicts of the root are detected sweeping all the paths together
+    ConflictDetector detector;
+    for (const auto& path : m_paths) {
+        detector.add_path(*path);
+    }
+    for (const auto& conflict : detector.pair_conflicts()) {
+        m_conflicts.emplace(std::pair{conflict.first_agent, conflict.second_agent}, conflict);
     }
 }
 
@@ -59,20 +60,52 @@ Node::Node(const Node& node,
            int agent,
            std::vector<Constraint>&& constraints,
            path_t goal_sequence,
-           const AmbientMapInstance& instance)
-    : m_constraints{std::move(constraints)},
-      m_paths{node.m_paths} {
+           const AmbientMapInstance& instance,
+           Planner planner)
+    : m_paths{node.m_paths},
+      m_constraints{std::make_shared<const ConstraintChain>(
+          ConstraintChain{.constraints = std::move(constraints), .parent = node.m_constraints})},
+      m_cost{node.m_cost},
+      m_conflicts{node.m_conflicts},
+      m_mdds{node.m_mdds} {
     auto start_location = goal_sequence.at(0);
     // remove start location from goal_sequence
     goal_sequence.erase(goal_sequence.cbegin());
-    m_paths[agent] = cmapd::multi_a_star::multi_a_star(
-        agent, start_location, goal_sequence, instance, m_constraints);
+    // only the path of agent is computed again, the others are shared with the parent
+    m_paths[agent] = std::make_shared<const path_t>(cmapd::multi_a_star::find_path(
+        planner, agent, start_location, goal_sequence, instance, agent_constraints(agent)));
+    m_cost += static_cast<int>(std::ssize(*m_paths[agent]) - std::ssize(*node.m_paths[agent]));
+    m_mdds[agent] = nullptr;
+    // only the pairs of agent are checked again
+    std::erase_if(m_conflicts, [agent](const auto& entry) {
+        return entry.first.first == agent || entry.first.second == agent;
+    });
+    for (int other = 0; other < std::ssize(m_paths); ++other) {
+        if (other == agent) continue;
+        const int first{std::min(agent, other)};
+        const int second{std::max(agent, other)};
+        if (auto conflict{ConflictDetector::first_conflict(
+                first, second, *m_paths[first], *m_paths[second])}) {
+            m_conflicts.emplace(std::pair{first, second}, conflict.value());
+        }
+    }
+}
+
+std::vector<Constraint> Node::agent_constraints(int agent) const {
+    std::vector<Constraint> constraints;
+    for (const ConstraintChain* link = m_constraints.get(); link != nullptr;
+         link = link->parent.get()) {
+        for (const auto& constraint : link->constraints) {
+            if (constraint.agent == agent) constraints.push_back(constraint);
+        }
+    }
+    return constraints;
 }
 
 std::vector<int> Node::lengths() const {
     std::vector<int> lengths;
     for (const auto& path : m_paths) {
-        lengths.emplace_back(std::ssize(path));
+        lengths.emplace_back(std::ssize(*path));
     }
     return lengths;
 }
@@ -80,79 +113,92 @@ std::vector<int> Node::lengths() const {
 int Node::makespan() const {
     int makespan = std::numeric_limits<int>::min();
     for (const auto& path : m_paths) {
-        int size = static_cast<int>(std::ssize(path));
+        int size = static_cast<int>(std::ssize(*path));
         makespan = size > makespan ? size : makespan;
     }
     return makespan;
 }
 
 std::optional<Conflict> Node::first_conflict() const {
-    auto n_paths = std::ssize(m_paths);
-    for (int i = 0; i < n_paths; ++i) {
-        for (int j = i + 1; j < n_paths; ++j) {
-            auto opt_conflict = detect_conflict(i, j, m_paths.at(i), m_paths.at(j));
-            if (opt_conflict) {
-                return opt_conflict;
-            }
-        }
+    if (m_conflicts.empty()) return {};
+    return m_conflicts.cbegin()->second;
+}
+
+const multi_a_star::Mdd& Node::mdd(int agent,
+                                   const AmbientMapInstance& instance,
+                                   const path_t& goal_sequence) {
+    if (!m_mdds[agent]) {
+        const path_t goals{goal_sequence.cbegin() + 1, goal_sequence.cend()};
+        m_mdds[agent] = std::make_shared<const multi_a_star::Mdd>(
+            agent,
+            goal_sequence.at(0),
+            goals,
+            static_cast<int>(std::ssize(*m_paths[agent])) - 1,
+            instance,
+            agent_constraints(agent));
     }
-    return {};
+    return *m_mdds[agent];
 }
 
-std::optional<Conflict> Node::detect_conflict(int first_agent,
-                                              int second_agent,
-                                              const path_t& first_path,
-                                              const path_t& second_path) {
-    auto length = std::ssize(first_path) > std::ssize(second_path) ? std::ssize(first_path)
-                                                                   : std::ssize(second_path);
-    for (int timestep = 0; timestep < length; ++timestep) {
-        // Check for vertex collision
-        auto first_pos = get_position(first_path, timestep);
-        auto second_pos = get_position(second_path, timestep);
-        if (first_pos == second_pos) {
-            return Conflict{
-                first_agent, second_agent, timestep, first_pos, second_pos, ConflictType::VERTEX};
+ConflictCardinality Node::cardinality(const Conflict& conflict,
+                                      const AmbientMapInstance& instance,
+                                      const std::vector<path_t>& goal_sequences) {
+    // test if the conflict can't be avoided by a path of an agent as long as the current one
+    const auto is_cardinal = [&](int agent, Point from, Point to) {
+        // after the end of its path, the agent can only stay in its last goal
+        const auto& agent_mdd{mdd(agent, instance, goal_sequences.at(agent))};
+        if (conflict.type == ConflictType::VERTEX) {
+            return agent_mdd.is_singleton(conflict.timestep, to);
         }
-        // Check for edge collision except for when we are in the last timestep
-        if (timestep < length - 1) {
-            auto first_next_pos = get_position(first_path, timestep + 1);
-            auto second_next_pos = get_position(second_path, timestep + 1);
-            if (first_pos == second_next_pos && second_pos == first_next_pos) {
-                return Conflict{first_agent,
-                                second_agent,
-                                timestep + 1,
-                                first_pos,
-                                first_next_pos,
-                                ConflictType::EDGE};
-            }
+        return agent_mdd.is_singleton(conflict.timestep - 1, from)
+               && agent_mdd.is_singleton(conflict.timestep, to);
+    };
+    const bool first_cardinal{
+        is_cardinal(conflict.first_agent, conflict.first_position, conflict.second_position)};
+    const bool second_cardinal{
+        is_cardinal(conflict.second_agent, conflict.second_position, conflict.first_position)};
+    if (first_cardinal && second_cardinal) return ConflictCardinality::CARDINAL;
+    if (first_cardinal || second_cardinal) return ConflictCardinality::SEMI_CARDINAL;
+    return ConflictCardinality::NON_CARDINAL;
+}
+
+std::optional<Conflict> Node::cardinal_conflict(const AmbientMapInstance& instance,
+                                                const std::vector<path_t>& goal_sequences) {
+    std::optional<Conflict> semi_cardinal;
+    for (const auto& [agents, conflict] : m_conflicts) {
+        const auto conflict_cardinality{cardinality(conflict, instance, goal_sequences)};
+        if (conflict_cardinality == ConflictCardinality::CARDINAL) return conflict;
+        if (conflict_cardinality == ConflictCardinality::SEMI_CARDINAL && !semi_cardinal) {
+            semi_cardinal = conflict;
         }
     }
-    return {};
+    return semi_cardinal ? semi_cardinal : first_conflict();
 }
 
-std::vector<path_t> Node::get_paths() const { return m_paths; }
-
-int Node::cost() const {
-    int cost = 0;
+std::vector<path_t> Node::get_paths() const {
+    std::vector<path_t> paths;
+    paths.reserve(m_paths.size());
     for (const auto& path : m_paths) {
-        cost += static_cast<int>(std::ssize(path));
+        paths.push_back(*path);
     }
-    return cost;
+    return paths;
 }
 
-int Node::num_conflicts() const {
-    auto n_paths = std::ssize(m_paths);
-    int num_conflicts = 0;
-    for (int i = 0; i < n_paths; ++i) {
-        for (int j = i + 1; j < n_paths; ++j) {
-            if (detect_conflict(i, j, m_paths.at(i), m_paths.at(j))) {
-                ++num_conflicts;
-            }
-        }
+const path_t& Node::get_path(int agent) const { return *m_paths.at(agent); }
+
+int Node::cost() const { return m_cost; }
+
+int Node::num_conflicts() const { return static_cast<int>(m_conflicts.size()); }
+
+std::vector<Constraint> Node::get_constraints() const {
+    std::vector<Constraint> constraints;
+    for (const ConstraintChain* link = m_constraints.get(); link != nullptr;
+         link = link->parent.get()) {
+        // the constraints of the ancestors come first
+        constraints.insert(
+            constraints.begin(), link->constraints.cbegin(), link->constraints.cend());
     }
-    return num_conflicts;
+    return constraints;
 }
 
-std::vector<Constraint> Node::get_constraints() const { return m_constraints; }
-
 }  // namespace cmapd::cbs
\ No newline at end of file
@@ -8,11 +8,17 @@
  */
 
 #pragma once
+#include <map>
+#include <memory>
 #include <optional>
+#include <utility>
 #include <vector>
 
 #include "Conflict.h"
+#include "ConflictCardinality.h"
 #include "Constraint.h"
+#include "a_star/Mdd.h"
+#include "a_star/Planner.h"
 #include "ambient/AmbientMapInstance.h"
 #include "custom_types.h"
 
@@ -20,26 +26,50 @@ namespace cmapd::cbs {
 
 /**
  * @class Node
- * @brief Represent a node of the cbs algorithm.
+ * @brief Represent a node of the cbs algorithm. The paths which aren't computed again and the
+ * constraints of the ancestors are shared with the parent, instead of being copied.
  */
 class Node {
   private:
-    /// the paths of the current node, one for every agent.
-    std::vector<path_t> m_paths;
+    /**
+     * @struct ConstraintChain
+     * @brief The constraints added by a node, linked to the ones of its parent.
+     */
+    struct ConstraintChain {
+        /// The constraints added by the node.
+        std::vector<Constraint> constraints;
+        /// The constraints of the parent, or nullptr for the root.
+        std::shared_ptr<const ConstraintChain> parent;
+    };
+
+    /// the paths of the current node, one for every agent, shared with the parent and the children.
+    std::vector<std::shared_ptr<const path_t>> m_paths;
     /// the constraints of the current node
-    std::vector<Constraint> m_constraints;
+    std::shared_ptr<const ConstraintChain> m_constraints;
+    /// the sum of all the paths lengths.
+    int m_cost{0};
+    /// the first conflict of every pair of agents in conflict, a child updates the ones of its
+    /// parent.
+    std::map<std::pair<int, int>, Conflict> m_conflicts;
+    /// the MDDs of the agents, built only when needed and shared with the children which don't
+    /// compute the path of the agent again.
+    std::vector<std::shared_ptr<const multi_a_star::Mdd>> m_mdds;
     /**
-     * Detect the first conflict in the provided paths, if present.
-     * @param first_agent The number of the first agent.
-     * @param second_agent The number of the second agent.
-     * @param first_path The path of the first agent.
-     * @param second_path The path of with the second agent.
-     * @return An optional containing the first conflict, if found, otherwise an empty optional.
+     * Get the MDD of an agent, building it if needed.
+     * @param agent The agent.
+     * @param instance The map instance on which we are operating.
+     * @param goal_sequence The goal sequence for agent.
+     * @return the MDD of the paths as long as the one of agent.
      */
-    static std::optional<Conflict> detect_conflict(int first_agent,
-                                                   int second_agent,
-                                                   const path_t& first_path,
-                                                   const path_t& second_path);
+    const multi_a_star::Mdd& mdd(int agent,
+                                 const AmbientMapInstance& instance,
+                                 const path_t& goal_sequence);
+    /**
+     * Get the constraints of an agent in the current node.
+     * @param agent The constrained agent.
+     * @return the constraints of agent.
+     */
+    [[nodiscard]] std::vector<Constraint> agent_constraints(int agent) const;
 
   public:
     /**
@@ -47,25 +77,29 @@ class Node {
      * @param instance The map instance on which we are operating.
      * @param goal_sequences The goal sequences for every agent.
      * @param constraints The constraints to take into account when computing paths.
+     * @param planner The algorithm used to find the path of a single agent.
      * @throws runtime_error if multi_a_star can't find a path for one agent.
      */
     explicit Node(const AmbientMapInstance& instance,
                   std::vector<path_t> goal_sequences,
-                  std::vector<Constraint>&& constraints = {});
+                  std::vector<Constraint>&& constraints = {},
+                  Planner planner = Planner::A_STAR);
     /**
      * Constructor for a child Node.
      * @param node The parent Node.
      * @param agent The agent for which we need to compute the path again.
-     * @param constraints The constraints to take into account when computing paths.
+     * @param constraints The constraints added to the ones of the parent.
      * @param goal_sequence The goal sequence for agent.
      * @param instance The map instance on which we are operating.
+     * @param planner The algorithm used to find the path of a single agent.
      * @throws runtime_error if multi_a_star can't find a path for one agent.
      */
     explicit Node(const Node& node,
                   int agent,
                   std::vector<Constraint>&& constraints,
                   path_t goal_sequence,
-                  const AmbientMapInstance& instance);
+                  const AmbientMapInstance& instance,
+                  Planner planner = Planner::A_STAR);
 
     /**
      * Get the lengths of every path.
@@ -78,7 +112,7 @@ class Node {
      */
     [[nodiscard]] int makespan() const;
     /**
-     * Get the sum of all the paths lengths.
+     * Get the sum of all the paths lengths, computed when the node was created.
      * @return the sum of all the paths lengths.
      */
     [[nodiscard]] int cost() const;
@@ -88,7 +122,27 @@ class Node {
      */
     [[nodiscard]] std::optional<Conflict> first_conflict() const;
     /**
-     * Get the number of conflicts in the calculated paths.
+     * Classify a conflict of the current node, using the MDDs of its agents.
+     * @param conflict A conflict between the paths of the node.
+     * @param instance The map instance on which we are operating.
+     * @param goal_sequences The goal sequences for every agent.
+     * @return the cardinality of the conflict.
+     */
+    ConflictCardinality cardinality(const Conflict& conflict,
+                                    const AmbientMapInstance& instance,
+                                    const std::vector<path_t>& goal_sequences);
+    /**
+     * Get the conflict on which the node should be split: the first cardinal conflict, if
+     * found, otherwise the first semi-cardinal conflict, otherwise the first conflict. Only the
+     * first conflict of every pair of agents is considered.
+     * @param instance The map instance on which we are operating.
+     * @param goal_sequences The goal sequences for every agent.
+     * @return an optional containing the conflict, if found, otherwise an empty optional.
+     */
+    std::optional<Conflict> cardinal_conflict(const AmbientMapInstance& instance,
+                                              const std::vector<path_t>& goal_sequences);
+    /**
+     * Get the number of conflicts in the calculated paths, computed when the node was created.
      * @return the number of conflicts in the calculated paths.
      */
     [[nodiscard]] int num_conflicts() const;
@@ -98,7 +152,13 @@ class Node {
      */
     [[nodiscard]] std::vector<path_t> get_paths() const;
     /**
-     * Get the constraints of the current node.
+     * Get the computed path of an agent.
+     * @param agent The agent.
+     * @return the path of agent.
+     */
+    [[nodiscard]] const path_t& get_path(int agent) const;
+    /**
+     * Get the constraints of the current node, including the ones of its ancestors.
      * @return the constraints of the current node.
      */
     [[nodiscard]] std::vector<Constraint> get_constraints() const;
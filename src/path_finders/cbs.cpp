@@ -7,7 +7,10 @@
  * @copyright 2022 Jacopo Zagoli, Davide Furlani
  */
 
+#include <compare>
+#include <functional>
 #include <optional>
+#include <utility>
 #include <queue>
 #include <stdexcept>
 #include <vector>
@@ -17,72 +20,95 @@
 #include "ConflictType.h"
 #include "Constraint.h"
 #include "Point.h"
+#include "a_star/Planner.h"
 #include "ambient/AmbientMapInstance.h"
 #include "custom_types.h"
+#include "path_finders/ConflictSelection.h"
 #include "path_finders/Node.h"
 
 namespace cmapd::cbs {
 
+/**
+ * @struct FrontierEntry
+ * @brief A node in the frontier of cbs, with the values which order it.
+ */
+struct FrontierEntry {
+    /// The cost of the node.
+    int cost;
+    /// The number of conflicts of the node, which breaks the ties on the cost.
+    int num_conflicts;
+    /// The index of the node, so that the ties are broken in order of creation.
+    int index;
+    /// Compares the cost, then the number of conflicts and the index.
+    auto operator<=>(const FrontierEntry& rhs) const = default;
+};
+
 std::vector<Constraint> generate_constraints(const Conflict& conflict,
                                              int agent_num,
                                              const AmbientMapInstance& instance);
 
-CmapdSolution cbs(const AmbientMapInstance& instance, const std::vector<path_t>& goal_sequences) {
-    // Compare two cbs nodes based on the cost, and then on the number of conflicts.
-    auto node_comparator = [](const Node& a, const Node& b) -> bool {
-        if (a.cost() != b.cost()) {
-            return a.cost() > b.cost();
-        } else {
-            return a.num_conflicts() > b.num_conflicts();
-        }
+CmapdSolution cbs(const AmbientMapInstance& instance,
+                  const std::vector<path_t>& goal_sequences,
+                  Planner planner,
+                  ConflictSelection selection) {
+    // The nodes, the frontier refers to them by index
+    std::vector<Node> nodes;
+    // The frontier with all the nodes, the cheapest first
+    std::priority_queue<FrontierEntry, std::vector<FrontierEntry>, std::greater<>> frontier;
+    const auto push = [&nodes, &frontier](Node&& node) {
+        frontier.push({.cost = node.cost(),
+                       .num_conflicts = node.num_conflicts(),
+                       .index = static_cast<int>(nodes.size())});
+        nodes.push_back(std::move(node));
     };
-    // The frontier with all the nodes
-    std::priority_queue<Node, std::vector<Node>, decltype(node_comparator)> frontier{
-        node_comparator};
 
     // 1. create root node
-    Node root{instance, goal_sequences};
+    Node root{instance, goal_sequences, {}, planner};
     // 2. push root in frontier
-    frontier.push(std::move(root));
+    push(std::move(root));
+    int expanded_nodes{0};
     // 3. while frontier not empty
     while (!frontier.empty()) {
         // 4. pop node
-        auto node = frontier.top();
+        const int index{frontier.top().index};
         frontier.pop();
-        // 5. get first conflict
-        std::optional<Conflict> conflict{node.first_conflict()};
-        // 6. if conflict not found, solution found
-        if (!conflict) {
-            return {.paths = node.get_paths(), .makespan = node.makespan(), .cost = node.cost()};
+        // 5. if conflict not found, solution found
+        if (nodes[index].num_conflicts() == 0) {
+            const Node& node{nodes[index]};
+            return {.paths = node.get_paths(),
+                    .makespan = node.makespan(),
+                    .cost = node.cost(),
+                    .expanded_nodes = expanded_nodes};
         }
+        ++expanded_nodes;
+        // 6. choose the conflict, the one which makes both the children more expensive if any
+        std::optional<Conflict> conflict{selection == ConflictSelection::CARDINAL
+                                             ? nodes[index].cardinal_conflict(instance,
+                                                                              goal_sequences)
+                                             : nodes[index].first_conflict()};
         // 7. if conflict found, create two nodes: one with constraint for first agent, one
-        //    with constraints for second agent
+        //    with constraints for second agent. They share the paths and the constraints of
+        //    the parent, except for the new ones.
 
         // first node
-        auto first_new_constraints = generate_constraints(conflict.value(), 1, instance);
-        std::vector<Constraint> first_constraints{node.get_constraints()};
-        first_constraints.insert(
-            first_constraints.end(), first_new_constraints.begin(), first_new_constraints.end());
-        Node first{node,
+        Node first{nodes[index],
                    conflict->first_agent,
-                   std::move(first_constraints),
+                   generate_constraints(conflict.value(), 1, instance),
                    goal_sequences.at(conflict->first_agent),
-                   instance};
+                   instance,
+                   planner};
 
         // second node
-        auto second_new_constraints = generate_constraints(conflict.value(), 2, instance);
-        std::vector<Constraint> second_constraints{node.get_constraints()};
-        second_constraints.insert(
-            second_constraints.end(), second_new_constraints.begin(), second_new_constraints.end());
-        Node second{node,
+        Node second{nodes[index],
                     conflict->second_agent,
-                    std::move(second_constraints),
+                    generate_constraints(conflict.value(), 2, instance),
                     goal_sequences.at(conflict->second_agent),
-                    instance};
+                    instance,
+                    planner};
 
         // 8. push nodes in the queue
-        frontier.push(first);
-        frontier.push(second);
+        push(std::move(first));
+        push(std::move(second));
     }
     // 9. if frontier is empty, no solution is found
     throw std::runtime_error{"Cbs didn't find a solution."};
@@ -120,12 +146,9 @@ std::vector<Constraint> generate_constraints(const Conflict& conflict,
         } else {
             agent = conflict.second_agent;
         }
-        for (moves_t moves{{0, 0}, {0, 1}, {1, 0}, {0, -1}, {-1, 0}}; const auto& move : moves) {
-            Point from_where = conflict.first_position + move;
-            if (instance.is_valid(from_where)) {
-                constraints.emplace_back(
-                    Constraint{agent, conflict.timestep, from_where, conflict.second_position});
-            }
+        for (const int cell : instance.neighbours(conflict.first_position)) {
+            constraints.emplace_back(Constraint{
+                agent, conflict.timestep, instance.cell_point(cell), conflict.second_position});
         }
     }
     return constraints;
@@ -12,8 +12,10 @@
 #include <vector>
 
 #include "CmapdSolution.h"
+#include "a_star/Planner.h"
 #include "ambient/AmbientMapInstance.h"
 #include "custom_types.h"
+#include "path_finders/ConflictSelection.h"
 
 namespace cmapd::cbs {
 
@@ -21,10 +23,16 @@ namespace cmapd::cbs {
  * This function finds paths without conflicts for every agent using a Conflict Based Search.
  * @param instance The ambient map instance on which we are operating.
  * @param goal_sequences A vector containing a goal sequence for every agent.
+ * @param planner The algorithm used to find the path of a single agent.
+ * @param selection How the conflict on which a node is split is chosen.
  * @return a solution, if found.
  * @throws runtime_error if no solution is found.
  * @see Conflict-Based Search For Optimal Multi-Agent Path Finding.
+ * @see ICBS: Improved Conflict-Based Search Algorithm for Multi-Agent Pathfinding.
  */
-CmapdSolution cbs(const AmbientMapInstance& instance, const std::vector<path_t>& goal_sequences);
+CmapdSolution cbs(const AmbientMapInstance& instance,
+                  const std::vector<path_t>& goal_sequences,
+                  Planner planner = Planner::A_STAR,
+                  ConflictSelection selection = ConflictSelection::CARDINAL);
 
 }
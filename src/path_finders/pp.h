@@ -10,6 +10,7 @@
 #include <vector>
 
 #include "CmapdSolution.h"
+#include "a_star/Planner.h"
 #include "ambient/AmbientMapInstance.h"
 #include "custom_types.h"
 
@@ -19,8 +20,11 @@ namespace cmapd::pp {
  * This function finds paths without conflicts for every agent using a Priority Based Search.
  * @param instance The ambient map instance on which we are operating.
  * @param goal_sequences A vector containing a goal sequence for every agent.
+ * @param planner The algorithm used to find the path of a single agent.
  * @return a solution, if found.
  * @throws runtime_error if no solution is found.
  */
-CmapdSolution pp(const AmbientMapInstance& instance, const std::vector<path_t>& goal_sequences);
+CmapdSolution pp(const AmbientMapInstance& instance,
+                 const std::vector<path_t>& goal_sequences,
+                 Planner planner = Planner::A_STAR);
 }  // namespace cmapd::pp
@@ -1,17 +1,120 @@
 //
 // Created by Jacopo on 02/11/2022.
 //
+#include <algorithm>
 #include <catch2/catch_test_macros.hpp>
 #include <iostream>
+#include <numeric>
+#include <optional>
+#include <random>
+#include <vector>
 
 #include "CmapdSolution.h"
+#include "Conflict.h"
+#include "ConflictCardinality.h"
+#include "ConflictType.h"
 #include "distances/distances.h"
+#include "path_finders/ConflictDetector.h"
 #include "path_finders/Node.h"
 #include "path_finders/cbs.h"
 #include "path_finders_utils.h"
 
 namespace {
 
+/// The first conflict between two paths, comparing them timestep by timestep.
+std::optional<cmapd::Conflict> pairwise_conflict(int first_agent,
+                                                 int second_agent,
+                                                 const cmapd::path_t& first_path,
+                                                 const cmapd::path_t& second_path) {
+    const auto position = [](const cmapd::path_t& path, int timestep) {
+        return timestep < std::ssize(path) ? path[timestep] : path.back();
+    };
+    const auto length{std::max(std::ssize(first_path), std::ssize(second_path))};
+    for (int timestep = 0; timestep < length; ++timestep) {
+        const auto first_pos{position(first_path, timestep)};
+        if (first_pos == position(second_path, timestep)) {
+            return cmapd::Conflict{first_agent,
+                                   second_agent,
+                                   timestep,
+                                   first_pos,
+                                   first_pos,
+                                   cmapd::ConflictType::VERTEX};
+        }
+        if (timestep < length - 1) {
+            const auto first_next_pos{position(first_path, timestep + 1)};
+            if (first_pos == position(second_path, timestep + 1)
+                && position(second_path, timestep) == first_next_pos) {
+                return cmapd::Conflict{first_agent,
+                                       second_agent,
+                                       timestep + 1,
+                                       first_pos,
+                                       first_next_pos,
+                                       cmapd::ConflictType::EDGE};
+            }
+        }
+    }
+    return {};
+}
+
+TEST_CASE("conflict detector", "[cbs]") {
+    using namespace cmapd;
+    SECTION("Vertex, edge and parked agents") {
+        const std::vector<path_t> paths{{{0, 0}, {0, 1}, {0, 2}},
+                                        {{0, 2}, {0, 1}, {0, 0}},
+                                        {{1, 0}, {0, 0}},
+                                        {{2, 2}}};
+        const ConflictDetector detector{paths};
+        REQUIRE(detector.first_conflict()
+                == Conflict{0, 1, 1, {0, 1}, {0, 1}, ConflictType::VERTEX});
+        // 2 arrives in (0, 0) after 0 left it, then 1 arrives there while 2 stays
+        REQUIRE(detector.num_conflicts() == 2);
+        const std::vector<Conflict> expected{
+            {0, 1, 1, {0, 1}, {0, 1}, ConflictType::VERTEX},
+            {1, 2, 2, {0, 0}, {0, 0}, ConflictType::VERTEX}};
+        REQUIRE(detector.conflicts() == expected);
+    }
+    SECTION("Swap") {
+        const std::vector<path_t> paths{{{0, 0}, {0, 1}}, {{0, 1}, {0, 0}}};
+        REQUIRE(ConflictDetector{paths}.conflicts()
+                == std::vector<Conflict>{{0, 1, 1, {0, 0}, {0, 1}, ConflictType::EDGE}});
+    }
+    SECTION("Same as comparing every pair of paths") {
+        std::mt19937 engine{7};
+        std::uniform_int_distribution<int> coordinate{0, 3};
+        std::uniform_int_distribution<int> length{1, 10};
+        std::uniform_int_distribution<int> random_move{0, 4};
+        const moves_t moves{{0, 0}, {0, 1}, {1, 0}, {0, -1}, {-1, 0}};
+        for (int round = 0; round < 200; ++round) {
+            std::vector<path_t> paths(6);
+            for (auto& path : paths) {
+                path.push_back({coordinate(engine), coordinate(engine)});
+                for (int step = length(engine); step > 1; --step) {
+                    const Point next{path.back() + moves[random_move(engine)]};
+                    path.push_back(next.row < 0 || next.row > 3 || next.col < 0 || next.col > 3
+                                       ? path.back()
+                                       : next);
+                }
+            }
+            std::optional<Conflict> first;
+            std::vector<Conflict> pair_conflicts;
+            for (int i = 0; i < std::ssize(paths); ++i) {
+                for (int j = i + 1; j < std::ssize(paths); ++j) {
+                    const auto conflict{pairwise_conflict(i, j, paths[i], paths[j])};
+                    REQUIRE(ConflictDetector::first_conflict(i, j, paths[i], paths[j])
+                            == conflict);
+                    if (conflict && !first) first = conflict;
+                    if (conflict) pair_conflicts.push_back(conflict.value());
+                }
+            }
+            const ConflictDetector detector{paths};
+            REQUIRE(detector.first_conflict() == first);
+            REQUIRE(detector.num_conflicts() == std::ssize(pair_conflicts));
+            // the pairs are sorted by their agents, like the ones of the loops above
+            REQUIRE(detector.pair_conflicts() == pair_conflicts);
+        }
+    }
+}
+
 TEST_CASE("cbs node", "[cbs]") {
     const std::vector<cmapd::path_t> goal_sequences_1
         = {{{1, 1}, {1, 2}, {3, 2}}, {{1, 3}, {3, 1}, {3, 3}}};
@@ -24,6 +127,7 @@ TEST_CASE("cbs node", "[cbs]") {
         REQUIRE(std::ssize(node1.get_paths()) == 2);
         REQUIRE(node1.lengths() == std::vector{6, 7});
         REQUIRE(node1.makespan() == 7);
+        REQUIRE(node1.cost() == 13);
 
         REQUIRE(std::ssize(node2.get_paths()) == 2);
         REQUIRE(node2.lengths() == std::vector{4, 3});
@@ -45,6 +149,65 @@ TEST_CASE("cbs node", "[cbs]") {
                              .second_position = {3, 2},
                              .type = cmapd::ConflictType::EDGE};
         REQUIRE(node2.first_conflict().value() == expected_conflict);
+        REQUIRE(node1.num_conflicts() == 1);
+        REQUIRE(node2.num_conflicts() == 1);
+    }
+    SECTION("Child") {
+        const cmapd::Constraint constraint{
+            .agent = 0, .timestep = 1, .from_position = {1, 1}, .to_position = {1, 2}};
+        const cmapd::cbs::Node child{node1, 0, {constraint}, goal_sequences_1[0], instance};
+        const cmapd::Constraint other_constraint{
+            .agent = 1, .timestep = 1, .from_position = {1, 3}, .to_position = {1, 2}};
+        const cmapd::cbs::Node grandchild{
+            child, 1, {other_constraint}, goal_sequences_1[1], instance};
+        // the path which isn't computed again is shared with the parent
+        REQUIRE(&child.get_path(1) == &node1.get_path(1));
+        REQUIRE(&grandchild.get_path(0) == &child.get_path(0));
+        REQUIRE(child.get_path(0) != node1.get_path(0));
+        REQUIRE(child.get_path(0).at(1) != cmapd::Point{1, 2});
+        REQUIRE(node1.get_constraints().empty());
+        REQUIRE(grandchild.get_constraints()
+                == std::vector<cmapd::Constraint>{constraint, other_constraint});
+        // the cost and the conflicts updated from the parent are the ones of the paths
+        for (const auto* node : {&child, &grandchild}) {
+            const auto paths{node->get_paths()};
+            const cmapd::ConflictDetector detector{paths};
+            const auto lengths{node->lengths()};
+            REQUIRE(node->cost() == std::accumulate(lengths.cbegin(), lengths.cend(), 0));
+            REQUIRE(node->num_conflicts() == detector.num_conflicts());
+            REQUIRE(node->first_conflict() == detector.first_conflict());
+        }
+    }
+}
+
+TEST_CASE("cbs conflict cardinality", "[cbs]") {
+    using namespace cmapd;
+    const AmbientMapInstance instance{"data/instance_1.txt", "data/map_1.txt"};
+    SECTION("Cardinal") {
+        // the agents swap their cells through the only short corridor
+        const std::vector<path_t> goal_sequences{{{1, 1}, {1, 3}}, {{1, 3}, {1, 1}}};
+        cbs::Node node{instance, goal_sequences};
+        const auto conflict{node.first_conflict()};
+        REQUIRE(conflict);
+        REQUIRE(node.cardinality(conflict.value(), instance, goal_sequences)
+                == ConflictCardinality::CARDINAL);
+        REQUIRE(node.cardinal_conflict(instance, goal_sequences) == conflict);
+    }
+    SECTION("Semi-cardinal") {
+        // the first agent can go around the wall in the same time, the second one can't
+        const std::vector<path_t> goal_sequences{{{1, 1}, {3, 3}}, {{1, 3}, {1, 1}}};
+        cbs::Node node{instance, goal_sequences};
+        const Conflict conflict{0, 1, 1, {1, 2}, {1, 2}, ConflictType::VERTEX};
+        REQUIRE(node.cardinality(conflict, instance, goal_sequences)
+                == ConflictCardinality::SEMI_CARDINAL);
+    }
+    SECTION("Non-cardinal") {
+        // both agents can go around the wall in the same time
+        const std::vector<path_t> goal_sequences{{{1, 1}, {3, 3}}, {{3, 1}, {1, 3}}};
+        cbs::Node node{instance, goal_sequences};
+        const Conflict conflict{0, 1, 1, {2, 1}, {2, 1}, ConflictType::VERTEX};
+        REQUIRE(node.cardinality(conflict, instance, goal_sequences)
+                == ConflictCardinality::NON_CARDINAL);
     }
 }
 
@@ -84,6 +247,17 @@ TEST_CASE("medium cbs search", "[cbs]") {
     REQUIRE_NOTHROW(solution.paths);
 }
 
+TEST_CASE("cbs search with sipp", "[cbs]") {
+    using namespace cmapd;
+    AmbientMapInstance instance{"data/instance_1.txt", "data/map_1.txt"};
+    std::vector<path_t> goal_sequences{{{1, 1}, {1, 2}, {3, 2}}, {{1, 3}, {3, 1}, {3, 3}}};
+    CmapdSolution solution{cbs::cbs(instance, goal_sequences, Planner::SIPP)};
+    REQUIRE(solution.paths.size() == 2);
+    REQUIRE(solution.cost == 14);
+    REQUIRE(solution.makespan == 7);
+    REQUIRE_NOTHROW(are_valid_routes(solution.paths));
+}
+
 TEST_CASE("advanced cbs search", "[cbs]") {
     using namespace cmapd;
     AmbientMapInstance instance{"data/instance_5.txt", "data/map_5.txt"};
@@ -109,6 +283,11 @@ TEST_CASE("advanced cbs search", "[cbs]") {
     REQUIRE(solution.paths[3].back() == Point{9, 4});
 
     REQUIRE_NOTHROW(are_valid_routes(solution.paths));
+    // splitting on the cardinal conflicts doesn't change the cost
+    const CmapdSolution first_solution{
+        cbs::cbs(instance, goal_sequences, Planner::A_STAR, cbs::ConflictSelection::FIRST)};
+    REQUIRE(first_solution.cost == solution.cost);
+    REQUIRE(solution.expanded_nodes <= first_solution.expanded_nodes);
 }
 
 }  // namespace
\ No newline at end of file
@@ -3,7 +3,14 @@
 //
 #include <catch2/catch_test_macros.hpp>
 
+#include <filesystem>
+#include <fstream>
+
+#include "a_star/multi_a_star.h"
+#include "distances/CompactDistanceTable.h"
+#include "distances/DistanceOracle.h"
 #include "distances/distances.h"
+#include "distances/h_table_cache.h"
 
 namespace {
 
@@ -34,6 +41,223 @@ TEST_CASE("compute h-table", "[distances]") {
         AmbientMapInstance instance{"data/instance_5.txt", "data/map_5.txt"};
         REQUIRE(std::ssize(instance.h_table().at({1, 0})) == 20);
     }
+    SECTION("Multiple threads") {
+        AmbientMapInstance instance{"data/instance_5.txt", "data/map_5.txt", {.threads = 1}};
+        REQUIRE(compute_h_table(instance, {.threads = 3}) == instance.h_table());
+        REQUIRE(compute_h_table(instance, {.threads = 64}) == instance.h_table());
+    }
+}
+
+TEST_CASE("lazy h-table", "[distances]") {
+    AmbientMapInstance instance{"data/instance_5.txt", "data/map_5.txt"};
+    const DistancesConfig config{.kernel = DistanceKernel::LAZY};
+
+    SECTION("Distances are computed when queried") {
+        auto h_table{compute_h_table(instance, config)};
+        const Point goal{instance.tasks()[0].second};
+        const int poi{h_table.poi_index(goal)};
+        REQUIRE_FALSE(h_table.is_complete(poi));
+        const Point start{instance.agents()[0]};
+        REQUIRE(h_table.distance(start, goal) == instance.h_table().distance(start, goal));
+        // neighbouring queries resume the same search
+        for (moves_t moves{{0, 1}, {1, 0}, {0, -1}, {-1, 0}}; const auto& move : moves) {
+            if (instance.is_valid(start + move)) {
+                REQUIRE(h_table.distance(start + move, goal)
+                        == instance.h_table().distance(start + move, goal));
+            }
+        }
+        for (int cell = h_table.num_cells() - 1; cell >= 0; --cell) {
+            REQUIRE(h_table.distance(cell, poi) == instance.h_table().distance(cell, poi));
+        }
+        REQUIRE(h_table.is_complete(poi));
+    }
+    SECTION("Completed table") {
+        REQUIRE(compute_h_table(instance, config) == instance.h_table());
+        AmbientMapInstance small{"data/instance_1.txt", "data/map_1.txt"};
+        auto h_table{compute_h_table(small, config)};
+        // (0,2) is a wall
+        REQUIRE(h_table.distance({0, 2}, {3, 1}) == DistanceTable::unreachable);
+        REQUIRE(h_table.is_complete(h_table.poi_index({3, 1})));
+        REQUIRE(h_table == small.h_table());
+        REQUIRE(h_table.at({1, 4}).at({3, 1}) == 5);
+        // the map is shared with the instance, not copied
+        REQUIRE(h_table.memory_usage() == small.h_table().memory_usage());
+    }
+    SECTION("The map outlives the instance") {
+        const auto h_table{
+            compute_h_table(AmbientMapInstance{"data/instance_1.txt", "data/map_1.txt"}, config)};
+        REQUIRE(h_table.at({1, 4}).at({3, 1}) == 5);
+    }
+}
+
+TEST_CASE("memory-bounded h-table", "[distances]") {
+    AmbientMapInstance instance{"data/instance_5.txt", "data/map_5.txt"};
+    const std::size_t column_size{sizeof(int) * instance.rows_number() * instance.columns_number()};
+    // room for the landmarks, the points of interest index and three columns
+    const DistancesConfig config{.memory_budget = 8 * column_size, .landmarks = 4};
+    auto h_table{compute_h_table(instance, config)};
+    REQUIRE(h_table.num_exact_pois() == 3);
+    REQUIRE(h_table.num_landmarks() == 4);
+    REQUIRE(h_table.memory_usage() < instance.h_table().memory_usage());
+    // the first points of interest are tasks endpoints
+    REQUIRE(h_table.pois()[0] == instance.tasks()[0].first);
+    for (int poi = 0; poi < h_table.num_pois(); ++poi) {
+        const int exact_poi{instance.h_table().poi_index(h_table.pois()[poi])};
+        for (int cell = 0; cell < h_table.num_cells(); ++cell) {
+            const int exact{instance.h_table().distance(cell, exact_poi)};
+            if (poi < h_table.num_exact_pois() || exact == DistanceTable::unreachable) {
+                REQUIRE(h_table.distance(cell, poi) == exact);
+            } else {
+                REQUIRE(h_table.distance(cell, poi) <= exact);
+            }
+        }
+    }
+    // the estimates are admissible, so the paths are still optimal
+    AmbientMapInstance bounded{"data/instance_5.txt", "data/map_5.txt", config};
+    const path_t goals{instance.tasks()[3].first, instance.tasks()[3].second};
+    REQUIRE(std::ssize(multi_a_star::multi_a_star(0, instance.agents()[0], goals, bounded))
+            == std::ssize(multi_a_star::multi_a_star(0, instance.agents()[0], goals, instance)));
+}
+
+TEST_CASE("h-table cache", "[distances]") {
+    const auto cache_directory{std::filesystem::temp_directory_path() / "cmapd_test_cache"};
+    std::filesystem::remove_all(cache_directory);
+    const DistancesConfig config{.cache_directory = cache_directory};
+    const AmbientMap map{"data/map_1.txt"};
+    const AmbientMapInstance instance{"data/instance_1.txt", "data/map_1.txt", {.threads = 1}};
+    const auto cache_file{
+        h_table_cache::cache_file(cache_directory, h_table_cache::map_hash(instance))};
+
+    SECTION("Store and load") {
+        REQUIRE(compute_h_table(instance, config) == instance.h_table());
+        REQUIRE(std::filesystem::exists(cache_file));
+        h_table_t h_table{instance.rows_number(), instance.columns_number(), {{1, 0}, {3, 2}}};
+        const auto hash{h_table_cache::map_hash(instance)};
+        auto loaded{h_table_cache::load(cache_directory, hash, h_table, {false, false})};
+        REQUIRE(loaded == std::vector{false, true});
+        REQUIRE(h_table.at({1, 0}).at({3, 2}) == 4);
+        // columns already filled are not copied
+        h_table_t filled{instance.rows_number(), instance.columns_number(), {{3, 2}}};
+        REQUIRE(h_table_cache::load(cache_directory, hash, filled, {true}) == std::vector{true});
+        REQUIRE(filled.distance({1, 0}, {3, 2}) == DistanceTable::unreachable);
+        REQUIRE(compute_h_table(instance, config) == instance.h_table());
+    }
+    SECTION("Only missing points of interest are added") {
+        const AmbientMapInstance first{map, {{1, 1}}, {}};
+        REQUIRE(compute_h_table(first, config) == first.h_table());
+        const auto size{std::filesystem::file_size(cache_file)};
+        const AmbientMapInstance second{map, {{1, 1}, {3, 3}}, {}};
+        REQUIRE(compute_h_table(second, config) == second.h_table());
+        const auto record_size{std::filesystem::file_size(cache_file) - size};
+        REQUIRE(record_size > 0);
+        REQUIRE(compute_h_table(second, config) == second.h_table());
+        REQUIRE(std::filesystem::file_size(cache_file) == size + record_size);
+    }
+    SECTION("Corrupted file") {
+        REQUIRE(compute_h_table(instance, config) == instance.h_table());
+        const auto size{std::filesystem::file_size(cache_file)};
+        {
+            std::fstream file{cache_file, std::ios::in | std::ios::out | std::ios::binary};
+            file.seekp(static_cast<std::streamoff>(size) - 1);
+            file.put(42);
+        }
+        REQUIRE(compute_h_table(instance, config) == instance.h_table());
+        std::filesystem::resize_file(cache_file, size - 1);
+        REQUIRE(compute_h_table(instance, config) == instance.h_table());
+        REQUIRE(std::filesystem::file_size(cache_file) == size);
+        std::filesystem::resize_file(cache_file, 3);
+        REQUIRE(compute_h_table(instance, config) == instance.h_table());
+        REQUIRE(std::filesystem::file_size(cache_file) == size);
+    }
+    std::filesystem::remove_all(cache_directory);
+}
+
+TEST_CASE("distance oracle", "[distances]") {
+    const AmbientMap map{"data/map_1.txt"};
+    // room for three columns of the 5x5 map
+    DistanceOracle oracle{map, 3 * 25 * sizeof(int)};
+    const DistancesConfig config{.oracle = &oracle};
+
+    SECTION("Shared columns") {
+        const AmbientMapInstance first{map, {{1, 1}, {1, 3}}, {}};
+        REQUIRE(compute_h_table(first, config) == first.h_table());
+        REQUIRE(oracle.size() == 2);
+        REQUIRE(oracle.misses() == 2);
+        const AmbientMapInstance second{map, {{1, 3}, {3, 3}}, {}};
+        REQUIRE(compute_h_table(second, config) == second.h_table());
+        REQUIRE(oracle.hits() == 1);
+        REQUIRE(oracle.misses() == 3);
+        REQUIRE(compute_h_table(second, config) == second.h_table());
+        REQUIRE(oracle.hits() == 3);
+        REQUIRE(oracle.memory_usage() == 3 * 25 * sizeof(int));
+    }
+    SECTION("Columns loaded from the cache are not misses") {
+        const auto cache_directory{std::filesystem::temp_directory_path() / "cmapd_test_oracle"};
+        std::filesystem::remove_all(cache_directory);
+        const AmbientMapInstance instance{map, {{1, 1}, {1, 3}}, {}};
+        REQUIRE(compute_h_table(instance, {.cache_directory = cache_directory})
+                == instance.h_table());
+        const DistancesConfig cached{.cache_directory = cache_directory, .oracle = &oracle};
+        REQUIRE(compute_h_table(instance, cached) == instance.h_table());
+        REQUIRE(oracle.size() == 2);
+        REQUIRE(oracle.misses() == 0);
+        std::filesystem::remove_all(cache_directory);
+    }
+    SECTION("Least recently used columns are discarded") {
+        const AmbientMapInstance first{map, {{1, 1}, {1, 2}, {1, 3}}, {}};
+        REQUIRE(compute_h_table(first, config) == first.h_table());
+        const AmbientMapInstance second{map, {{1, 1}}, {}};
+        REQUIRE(compute_h_table(second, config) == second.h_table());
+        const AmbientMapInstance third{map, {{3, 3}}, {}};
+        REQUIRE(compute_h_table(third, config) == third.h_table());
+        REQUIRE(oracle.size() == 3);
+        // (1,2) was the least recently used column
+        h_table_t h_table{map.rows_number(), map.columns_number(), {{1, 1}, {1, 2}, {1, 3}}};
+        REQUIRE(oracle.load(h_table) == std::vector{true, false, true});
+        REQUIRE(h_table.at({3, 1}).at({1, 3}) == 4);
+    }
+    SECTION("Wrong map") {
+        h_table_t h_table{4, 5, {{1, 1}}};
+        REQUIRE_THROWS_AS(oracle.load(h_table), std::runtime_error);
+    }
+}
+
+TEST_CASE("compact distance table", "[distances]") {
+    AmbientMapInstance instance{"data/instance_5.txt", "data/map_5.txt"};
+    const auto& h_table{instance.h_table()};
+    const CompactDistanceTable compact{h_table};
+    REQUIRE(compact.num_pois() == h_table.num_pois());
+    REQUIRE(compact.memory_usage() < h_table.memory_usage());
+    for (const Point poi : h_table.pois()) {
+        for (int row = 0; row < instance.rows_number(); ++row) {
+            for (int col = 0; col < instance.columns_number(); ++col) {
+                REQUIRE(compact.distance({row, col}, poi) == h_table.distance({row, col}, poi));
+            }
+        }
+    }
+    DistanceTable far{1, 2, {{0, 0}}};
+    far.set_distance(1, 0, CompactDistanceTable::max_distance + 1);
+    REQUIRE_THROWS_AS(CompactDistanceTable{far}, std::overflow_error);
+}
+
+TEST_CASE("distance table", "[distances]") {
+    DistanceTable table{3, 4, {{0, 1}, {2, 3}, {0, 1}}};
+    REQUIRE(table.num_cells() == 12);
+    // duplicated points of interest are stored once
+    REQUIRE(table.num_pois() == 2);
+    REQUIRE(table.poi_index({2, 3}) == 1);
+    REQUIRE(table.poi_index({1, 1}) == -1);
+    REQUIRE(table.cell_index({2, 3}) == 11);
+    REQUIRE(table.distance({1, 1}, {2, 3}) == DistanceTable::unreachable);
+    REQUIRE(std::ssize(table) == 0);
+    table.set_distance(table.cell_index({1, 1}), 1, 3);
+    REQUIRE(table.distance({1, 1}, {2, 3}) == 3);
+    REQUIRE(table.at({1, 1}).at({2, 3}) == 3);
+    REQUIRE(std::ssize(table) == 1);
+    // unreachable, outside the map or not a point of interest
+    REQUIRE_THROWS_AS(table.at({1, 1}).at({0, 1}), std::out_of_range);
+    REQUIRE_THROWS_AS(table.at({1, 1}).at({1, 2}), std::out_of_range);
+    REQUIRE_THROWS_AS(table.at({3, 0}), std::out_of_range);
 }
 
 TEST_CASE("compute h-distance", "[distances]") {
@@ -1,7 +1,7 @@
 //
 // Created by dade on 30/10/22.
 //
-#include <ambient/AmbientMapInstance.h>
+#include <ambient/AmbientMap.h>
 
 #include <catch2/catch_test_macros.hpp>
 
@@ -42,12 +42,12 @@ TEST_CASE("test generation instances", "[generate_instances]") {
     n_tasks = 2;
     REQUIRE_NOTHROW(generate_instances(map, save_path, n_instances, n_agents, n_tasks));
 
-    std::vector<cmapd::AmbientMapInstance> instances
+    std::vector<cmapd::InstanceContents> instances
         = generate_instances(map, save_path, n_instances, n_agents, n_tasks);
 
     REQUIRE(static_cast<int>(instances.size()) == n_instances);
-    REQUIRE(instances[0].num_agents() == 2);
-    REQUIRE(instances[0].num_tasks() == 2);
+    REQUIRE(instances[0].agents.size() == 2);
+    REQUIRE(instances[0].tasks.size() == 2);
 }
 
 }  // namespace
\ No newline at end of file
@@ -16,6 +16,9 @@ TEST_CASE("test assign map", "[instantiation_map]") {
     path_to_map = "data/map_wrong.txt";
     REQUIRE_THROWS_AS(AmbientMap(path_to_map), std::runtime_error);
 
+    path_to_map = "data/map_not_rectangular.txt";
+    REQUIRE_THROWS_AS(AmbientMap(path_to_map), std::runtime_error);
+
     path_to_map = "data/map_1.txt";
     REQUIRE_NOTHROW(AmbientMap(path_to_map));
 }
@@ -86,10 +89,53 @@ TEST_CASE("test if a point is valid in a map", "[is_valid_point_map]") {
     REQUIRE(map.is_valid(valid_point));
 }
 
+TEST_CASE("test if a point is passable in a map", "[is_passable_point_map]") {
+    std::filesystem::path path_to_map{"data/map_1.txt"};
+    AmbientMap map{path_to_map};
+
+    // the border around the map is made of walls
+    REQUIRE_FALSE(map.is_passable({-1, -1}));
+    REQUIRE_FALSE(map.is_passable({1, -1}));
+    REQUIRE_FALSE(map.is_passable({5, 5}));
+    REQUIRE_FALSE(map.is_passable({0, 2}));
+    // free cells and generation positions
+    REQUIRE(map.is_passable({1, 0}));
+    REQUIRE(map.is_passable({1, 2}));
+    REQUIRE(map.to_rows()[1] == std::vector<char>{' ', 'O', 'O', 'O', ' '});
+}
+
+TEST_CASE("test the neighbours of a cell", "[neighbours_map]") {
+    std::filesystem::path path_to_map{"data/map_1.txt"};
+    AmbientMap map{path_to_map};
+
+    auto to_points = [&map](std::span<const int> cells) {
+        std::vector<cmapd::Point> points;
+        for (int cell : cells) points.push_back(map.cell_point(cell));
+        return points;
+    };
+    // the wait move comes first
+    REQUIRE(to_points(map.neighbours({1, 0})) == std::vector<cmapd::Point>{{1, 0}, {1, 1}});
+    REQUIRE(to_points(map.neighbours({1, 1}))
+            == std::vector<cmapd::Point>{{1, 1}, {1, 2}, {2, 1}, {1, 0}});
+    // walls have no neighbours
+    REQUIRE(map.neighbours({0, 0}).empty());
+    REQUIRE(map.cell_index({2, 3}) == 13);
+    REQUIRE(map.cell_point(13) == cmapd::Point{2, 3});
+}
+
 TEST_CASE("test if to_string return the correct map string", "[to_string_method_map]") {
     std::filesystem::path path_to_map{"data/map_1.txt"};
     AmbientMap map{path_to_map};
 
     REQUIRE(map.to_string() == "#####\n OOO \n# # #\n OOO \n#####\n");
 }
+
+TEST_CASE("test a MovingAI map", "[moving_ai_map]") {
+    std::filesystem::path path_to_map{"data/moving_ai.map"};
+    AmbientMap map{path_to_map};
+
+    REQUIRE(map.rows_number() == 4);
+    REQUIRE(map.columns_number() == 5);
+    REQUIRE(map.to_string() == "OOOOO\nO###O\nOOOOO\nOO#OO\n");
+}
 }  // namespace
\ No newline at end of file
@@ -3,8 +3,10 @@
 //
 
 #include <ambient/AmbientMapInstance.h>
+#include <ambient/instance_io.h>
 
 #include <catch2/catch_test_macros.hpp>
+#include <memory>
 
 namespace {
 using cmapd::AmbientMapInstance;
@@ -83,4 +85,77 @@ TEST_CASE("test if to_string return the correct instance string", "[to_string_me
 
     REQUIRE(instance.to_string() == "#####\n ata \n# # #\n ttt \n#####\n");
 }
+
+TEST_CASE("test instances sharing a map", "[shared_map_instance]") {
+    const auto map{std::make_shared<const cmapd::AmbientMap>("data/map_1.txt")};
+    AmbientMapInstance first{map, "data/instance_1.txt"};
+    AmbientMapInstance second{map, std::vector<cmapd::Point>{{1, 1}}, {}};
+
+    REQUIRE(&first.ambient_map() == map.get());
+    REQUIRE(&second.ambient_map() == map.get());
+    // the agents and the tasks of an instance don't change the map
+    REQUIRE(map->to_string() == "#####\n OOO \n# # #\n OOO \n#####\n");
+    REQUIRE(first.to_string() == "#####\n ata \n# # #\n ttt \n#####\n");
+    REQUIRE(second.to_string() == "#####\n a   \n# # #\n     \n#####\n");
+}
+
+TEST_CASE("test a MovingAI scenario", "[moving_ai_instance]") {
+    std::filesystem::path path_to_map{"data/moving_ai.map"};
+    std::filesystem::path path_to_instance{"data/moving_ai.scen"};
+    AmbientMapInstance instance{path_to_instance, path_to_map};
+
+    const std::vector<cmapd::Point> expected_agents{{0, 0}, {0, 4}};
+    std::vector<std::pair<cmapd::Point, cmapd::Point>> expected_tasks{};
+    expected_tasks.emplace_back(cmapd::Point{0, 0}, cmapd::Point{3, 4});
+    expected_tasks.emplace_back(cmapd::Point{0, 4}, cmapd::Point{3, 0});
+    REQUIRE(instance.agents() == expected_agents);
+    REQUIRE(instance.tasks() == expected_tasks);
+    REQUIRE(instance.h_table().distance({0, 0}, {3, 4}) == 7);
+
+    // a start on a wall
+    path_to_instance = "data/moving_ai_wall.scen";
+    REQUIRE_THROWS_AS(AmbientMapInstance(path_to_instance, path_to_map), std::runtime_error);
+    // a scenario for another map
+    REQUIRE_THROWS_AS(AmbientMapInstance("data/moving_ai.scen", "data/map_1.txt"),
+                      std::runtime_error);
+}
+
+TEST_CASE("test binary instances and solutions", "[binary_instance]") {
+    std::filesystem::path path_to_map{"data/map_5.txt"};
+    std::filesystem::path path_to_instance{"data/instance_5.txt"};
+    AmbientMapInstance instance{path_to_instance, path_to_map};
+    const auto binary_path{std::filesystem::temp_directory_path() / "cmapd_instance_5.bin"};
+    const auto text_path{std::filesystem::temp_directory_path() / "cmapd_instance_5.txt"};
+
+    // text -> binary -> text gives back the same instance
+    const cmapd::InstanceContents contents{instance.agents(), instance.tasks()};
+    cmapd::save_instance(
+        instance.ambient_map(), contents, binary_path, cmapd::InstanceFormat::BINARY);
+    AmbientMapInstance binary_instance{binary_path, path_to_map};
+    REQUIRE(binary_instance.agents() == instance.agents());
+    REQUIRE(binary_instance.tasks() == instance.tasks());
+    cmapd::save_instance(instance.ambient_map(),
+                         cmapd::load_instance(binary_path, instance.ambient_map()),
+                         text_path,
+                         cmapd::InstanceFormat::TEXT);
+    AmbientMapInstance text_instance{text_path, path_to_map};
+    REQUIRE(text_instance.agents() == instance.agents());
+    REQUIRE(text_instance.tasks() == instance.tasks());
+    // a binary instance for another map
+    REQUIRE_THROWS_AS(AmbientMapInstance(binary_path, "data/map_1.txt"), std::runtime_error);
+
+    const cmapd::CmapdSolution solution{
+        .paths = {{{1, 1}, {1, 2}}, {}, {{3, 3}}}, .makespan = 2, .cost = 3};
+    const auto solution_path{std::filesystem::temp_directory_path() / "cmapd_solution.sol"};
+    cmapd::save_solution(solution, solution_path);
+    const auto loaded{cmapd::load_solution(solution_path)};
+    REQUIRE(loaded.paths == solution.paths);
+    REQUIRE(loaded.makespan == 2);
+    REQUIRE(loaded.cost == 3);
+    REQUIRE_THROWS_AS(cmapd::load_solution(binary_path), std::runtime_error);
+
+    std::filesystem::remove(binary_path);
+    std::filesystem::remove(text_path);
+    std::filesystem::remove(solution_path);
+}
 }  // namespace
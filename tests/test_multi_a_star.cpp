@@ -3,22 +3,53 @@
 //
 
 #include <catch2/catch_test_macros.hpp>
+#include <cstdint>
+#include <stdexcept>
 
+#include "a_star/ConstraintTable.h"
 #include "a_star/Frontier.h"
+#include "a_star/GoalSequence.h"
+#include "a_star/Mdd.h"
 #include "a_star/Node.h"
+#include "a_star/NodePool.h"
+#include "a_star/StateSet.h"
 #include "a_star/multi_a_star.h"
+#include "a_star/sipp.h"
+#include "distances/distances.h"
 
 namespace {
 using namespace cmapd;
 const std::vector<Point> goal_sequence = {{1, 2}, {3, 2}, {3, 1}, {3, 3}};
 const AmbientMapInstance instance{"data/instance_1.txt", "data/map_1.txt"};
+const multi_a_star::GoalSequence sequence{instance.h_table(), goal_sequence};
+
+/// The packed state of a Node of the tests, at the timestep equal to its g-value.
+std::uint64_t state(const multi_a_star::Node& node) {
+    return multi_a_star::pack_state(
+        instance.cell_index(node.get_location()), node.get_g_value(), node.get_label());
+}
+
+TEST_CASE("Multi A* goal sequence", "[multi A*]") {
+    REQUIRE(sequence.goals() == goal_sequence);
+    for (int label = 0; label < std::ssize(goal_sequence); ++label) {
+        REQUIRE(sequence.h_value({1, 0}, label)
+                == multi_a_star::compute_h_value({1, 0}, label, instance.h_table(), goal_sequence));
+    }
+    // distance from (1,0) to (3,1), then to (3,3)
+    REQUIRE(sequence.h_value({1, 0}, 2) == 5);
+    REQUIRE(sequence.h_value({1, 0}, 4) == 0);
+    // the agent of instance_6 is walled in, away from its task
+    const AmbientMapInstance walled_instance{"data/instance_6.txt", "data/map_6.txt"};
+    REQUIRE_THROWS_AS((multi_a_star::GoalSequence{walled_instance.h_table(), {{1, 1}, {3, 0}}}),
+                      std::out_of_range);
+}
 
 TEST_CASE("Multi A* node equality", "[multi A*]") {
-    multi_a_star::Node node{{1, 0}, instance.h_table(), goal_sequence};
-    multi_a_star::Node node1{{1, 0}, instance.h_table(), goal_sequence};
-    multi_a_star::Node node2{{1, 0}, node, instance.h_table(), goal_sequence};
-    multi_a_star::Node node3{{1, 1}, instance.h_table(), goal_sequence};
-    multi_a_star::Node node4{{1, 1}, node, instance.h_table(), goal_sequence};
+    multi_a_star::Node node{{1, 0}, sequence};
+    multi_a_star::Node node1{{1, 0}, sequence};
+    multi_a_star::Node node2{{1, 0}, node, 0};
+    multi_a_star::Node node3{{1, 1}, sequence};
+    multi_a_star::Node node4{{1, 1}, node, 0};
     REQUIRE(node == node1);
     REQUIRE(node != node2);
     REQUIRE(node != node3);
@@ -26,102 +57,300 @@ TEST_CASE("Multi A* node equality", "[multi A*]") {
 }
 
 TEST_CASE("Multi A* node children", "[multi A*]") {
-    multi_a_star::Node node{{1, 0}, instance.h_table(), goal_sequence};
-    std::vector<multi_a_star::Node> children{node.get_children(instance)};
+    multi_a_star::Node node{{1, 0}, sequence};
+    std::vector<multi_a_star::Node> children{node.get_children(instance, 0)};
     REQUIRE(std::ssize(children) == 2l);
 
-    multi_a_star::Node node1{{1, 1}, instance.h_table(), goal_sequence};
-    children = node1.get_children(instance);
+    multi_a_star::Node node1{{1, 1}, sequence};
+    children = node1.get_children(instance, 0);
     REQUIRE(std::ssize(children) == 4l);
 
-    multi_a_star::Node node2{{2, 1}, instance.h_table(), goal_sequence};
-    children = node2.get_children(instance);
+    multi_a_star::Node node2{{2, 1}, sequence};
+    children = node2.get_children(instance, 0);
     REQUIRE(std::ssize(children) == 3l);
 }
 
 TEST_CASE("Multi A* path", "[multi A*]") {
-    multi_a_star::Node parent{{1, 0}, instance.h_table(), goal_sequence};
-    multi_a_star::Node child1{{1, 1}, parent, instance.h_table(), goal_sequence};
-    multi_a_star::Node child2{{1, 2}, child1, instance.h_table(), goal_sequence};
-    multi_a_star::Node child3{{1, 3}, child2, instance.h_table(), goal_sequence};
-    multi_a_star::Node child4{{2, 3}, child3, instance.h_table(), goal_sequence};
+    multi_a_star::NodePool pool;
+    const int parent{pool.add(multi_a_star::Node{{1, 0}, sequence})};
+    const int child1{pool.add(multi_a_star::Node{{1, 1}, pool[parent], parent})};
+    const int child2{pool.add(multi_a_star::Node{{1, 2}, pool[child1], child1})};
+    const int child3{pool.add(multi_a_star::Node{{1, 3}, pool[child2], child2})};
+    multi_a_star::Node child4{{2, 3}, pool[child3], child3};
+    REQUIRE(pool.size() == 4);
+    REQUIRE(child4.get_parent() == child3);
+    REQUIRE(pool[parent].get_parent() == multi_a_star::Node::no_parent);
     // final path
-    auto path = child4.get_path();
+    auto path = pool.path(child4);
     path_t expected_path{{1, 0}, {1, 1}, {1, 2}, {1, 3}, {2, 3}};
     REQUIRE(std::ssize(path) == 5);
     REQUIRE(path == expected_path);
     // intermediate path
-    path = child2.get_path();
+    path = pool.path(pool[child2]);
     expected_path = {{1, 0}, {1, 1}, {1, 2}};
     REQUIRE(std::ssize(path) == 3);
     REQUIRE(path == expected_path);
 }
 
+TEST_CASE("Multi A* closed set", "[multi A*]") {
+    using multi_a_star::pack_state;
+    // the cell, the timestep and the label of a state are all part of it
+    REQUIRE(pack_state(3, 5, 1) != pack_state(3, 5, 2));
+    REQUIRE(pack_state(3, 5, 1) != pack_state(3, 6, 1));
+    REQUIRE(pack_state(3, 5, 1) != pack_state(4, 5, 1));
+    REQUIRE(pack_state(3, multi_a_star::any_timestep, multi_a_star::max_state_label)
+            != pack_state(4, 0, 0));
+
+    multi_a_star::StateSet closed{4};
+    REQUIRE(closed.size() == 0);
+    REQUIRE_FALSE(closed.contains(pack_state(0, 0, 0)));
+    REQUIRE(closed.insert(pack_state(0, 0, 0)));
+    REQUIRE_FALSE(closed.insert(pack_state(0, 0, 0)));
+    REQUIRE(closed.contains(pack_state(0, 0, 0)));
+    // the set grows past its initial capacity
+    for (int cell = 1; cell < 1000; ++cell) {
+        REQUIRE(closed.insert(pack_state(cell, cell % 7, cell % 3)));
+    }
+    REQUIRE(closed.size() == 1000);
+    for (int cell = 1; cell < 1000; ++cell) {
+        REQUIRE(closed.contains(pack_state(cell, cell % 7, cell % 3)));
+        REQUIRE_FALSE(closed.contains(pack_state(cell, cell % 7, cell % 3 + 1)));
+    }
+}
+
+TEST_CASE("Multi A* constraint table", "[multi A*]") {
+    const std::vector<Constraint> constraints{
+        {.agent = 0, .timestep = 2, .from_position = {1, 3}, .to_position = {2, 3}},
+        {.agent = 1, .timestep = 2, .from_position = {1, 3}, .to_position = {1, 2}},
+        {.agent = 0,
+         .timestep = 6,
+         .from_position = {1, 1},
+         .to_position = {1, 2},
+         .final = true},
+        {.agent = 0,
+         .timestep = 4,
+         .from_position = {1, 1},
+         .to_position = {1, 2},
+         .final = true}};
+    const multi_a_star::ConstraintTable table{constraints, 0, instance};
+    REQUIRE(table.last_timestep() == 6);
+    REQUIRE(table.is_constrained(2, {1, 3}, {2, 3}));
+    REQUIRE_FALSE(table.is_constrained(3, {1, 3}, {2, 3}));
+    REQUIRE_FALSE(table.is_constrained(2, {2, 3}, {1, 3}));
+    // the constraints of the other agents are ignored
+    REQUIRE_FALSE(table.is_constrained(2, {1, 3}, {1, 2}));
+    // the earliest final constraint of a move holds from its timestep on
+    REQUIRE_FALSE(table.is_constrained(3, {1, 1}, {1, 2}));
+    REQUIRE(table.is_constrained(4, {1, 1}, {1, 2}));
+    REQUIRE(table.is_constrained(100, {1, 1}, {1, 2}));
+    // an agent without constraints
+    const multi_a_star::ConstraintTable empty_table{constraints, 2, instance};
+    REQUIRE(empty_table.last_timestep() == 0);
+    REQUIRE_FALSE(empty_table.is_constrained(2, {1, 3}, {2, 3}));
+}
+
+TEST_CASE("Multi A* safe intervals", "[multi A*]") {
+    const std::vector<Constraint> constraints{
+        {.agent = 0, .timestep = 3, .from_position = {1, 2}, .to_position = {1, 2}},
+        {.agent = 0, .timestep = 4, .from_position = {1, 2}, .to_position = {1, 2}},
+        {.agent = 0, .timestep = 4, .from_position = {1, 1}, .to_position = {1, 2}},
+        {.agent = 0, .timestep = 8, .from_position = {1, 2}, .to_position = {1, 2}},
+        {.agent = 0,
+         .timestep = 6,
+         .from_position = {3, 3},
+         .to_position = {3, 3},
+         .final = true}};
+    const multi_a_star::ConstraintTable table{constraints, 0, instance};
+    using multi_a_star::SafeInterval;
+    REQUIRE(table.safe_intervals({1, 1}) == std::vector<SafeInterval>{{0, SafeInterval::forever}});
+    // the agent can arrive from another cell in a timestep in which it can't wait
+    REQUIRE(table.safe_intervals({1, 2})
+            == std::vector<SafeInterval>{{0, 2}, {3, 3}, {4, 7}, {8, SafeInterval::forever}});
+    REQUIRE(table.safe_intervals({3, 3}) == std::vector<SafeInterval>{{0, 5}});
+    // a path can end in a cell only after its last forbidden wait
+    REQUIRE(table.can_stay({1, 1}, 0));
+    REQUIRE_FALSE(table.can_stay({1, 2}, 7));
+    REQUIRE(table.can_stay({1, 2}, 8));
+    REQUIRE_FALSE(table.can_stay({3, 3}, 10));
+}
+
+TEST_CASE("Multi A* MDD", "[multi A*]") {
+    SECTION("Single path") {
+        const multi_a_star::Mdd mdd{0, {1, 1}, {{3, 1}}, 2, instance, {}};
+        REQUIRE(mdd.cost() == 2);
+        REQUIRE(mdd.is_singleton(0, {1, 1}));
+        REQUIRE(mdd.is_singleton(1, {2, 1}));
+        REQUIRE(mdd.is_singleton(2, {3, 1}));
+        // the agent stays in its last goal
+        REQUIRE(mdd.is_singleton(5, {3, 1}));
+    }
+    SECTION("Two paths") {
+        const multi_a_star::Mdd mdd{0, {1, 1}, {{3, 3}}, 4, instance, {}};
+        REQUIRE(mdd.cells(1) == std::vector<Point>{{1, 2}, {2, 1}});
+        REQUIRE(mdd.cells(2) == std::vector<Point>{{1, 3}, {3, 1}});
+        REQUIRE_FALSE(mdd.is_singleton(2, {1, 3}));
+        REQUIRE(mdd.is_singleton(4, {3, 3}));
+    }
+    SECTION("Goal labels") {
+        // the agent must come back to its start after the first goal
+        const multi_a_star::Mdd mdd{0, {1, 1}, {{1, 2}, {1, 1}}, 2, instance, {}};
+        REQUIRE(mdd.is_singleton(1, {1, 2}));
+        REQUIRE(mdd.is_singleton(2, {1, 1}));
+    }
+    SECTION("Constraints") {
+        const std::vector<Constraint> constraints{
+            {.agent = 0, .timestep = 1, .from_position = {1, 1}, .to_position = {1, 2}}};
+        const multi_a_star::Mdd mdd{0, {1, 1}, {{3, 3}}, 4, instance, constraints};
+        REQUIRE(mdd.is_singleton(1, {2, 1}));
+        REQUIRE(mdd.is_singleton(3, {3, 2}));
+        REQUIRE_THROWS(multi_a_star::Mdd{0, {1, 1}, {{3, 3}}, 3, instance, {}});
+    }
+    SECTION("Parking") {
+        // the agent can't stay in its goal at timestep 5, so its paths must end later
+        std::vector<Constraint> constraints;
+        for (const int cell : instance.neighbours(Point{3, 1})) {
+            constraints.push_back({.agent = 0,
+                                   .timestep = 5,
+                                   .from_position = instance.cell_point(cell),
+                                   .to_position = {3, 1}});
+        }
+        REQUIRE_THROWS(multi_a_star::Mdd{0, {1, 1}, {{3, 1}}, 2, instance, constraints});
+        REQUIRE_THROWS(multi_a_star::Mdd{0, {1, 1}, {{3, 1}}, 4, instance, constraints});
+        const multi_a_star::Mdd mdd{0, {1, 1}, {{3, 1}}, 6, instance, constraints};
+        REQUIRE(mdd.is_singleton(6, {3, 1}));
+        REQUIRE_FALSE(mdd.is_singleton(5, {3, 1}));
+    }
+}
+
 TEST_CASE("Multi A* Frontier", "[multi A*]") {
     SECTION("Empty frontier, push and pop") {
         multi_a_star::Frontier frontier{};
         REQUIRE(frontier.empty());
-        multi_a_star::Node node{{1, 0}, instance.h_table(), goal_sequence};
-        frontier.push(node);
+        multi_a_star::Node node{{1, 0}, sequence};
+        frontier.push(node, state(node));
         multi_a_star::Node node1{frontier.pop()};
         REQUIRE(frontier.empty());
         REQUIRE(node == node1);
     }
     SECTION("Pop node with smaller f-value") {
         multi_a_star::Frontier frontier{};
-        multi_a_star::Node node{{1, 0}, instance.h_table(), goal_sequence};
-        multi_a_star::Node node1{{1, 1}, instance.h_table(), goal_sequence};
-        multi_a_star::Node node2{{1, 2}, instance.h_table(), goal_sequence};
+        multi_a_star::Node node{{1, 0}, sequence};
+        multi_a_star::Node node1{{1, 1}, sequence};
+        multi_a_star::Node node2{{1, 2}, sequence};
         REQUIRE(node.get_f_value() > node1.get_f_value());
         REQUIRE(node1.get_f_value() > node2.get_f_value());
-        frontier.push(node);
-        frontier.push(node2);
-        frontier.push(node1);
+        frontier.push(node, state(node));
+        frontier.push(node2, state(node2));
+        frontier.push(node1, state(node1));
         multi_a_star::Node res = frontier.pop();
         REQUIRE(res == node2);
-        REQUIRE_FALSE(frontier.contains(node2));
+        REQUIRE_FALSE(frontier.contains(state(node2)));
     }
     SECTION("Contains Point") {
         multi_a_star::Frontier frontier{};
-        multi_a_star::Node node{{1, 0}, instance.h_table(), goal_sequence};
-        multi_a_star::Node node1{{1, 1}, instance.h_table(), goal_sequence};
-        frontier.push(node);
-        REQUIRE(frontier.contains(node));
-        REQUIRE_FALSE(frontier.contains(node1));
+        multi_a_star::Node node{{1, 0}, sequence};
+        multi_a_star::Node node1{{1, 1}, sequence};
+        frontier.push(node, state(node));
+        REQUIRE(frontier.contains(state(node)));
+        REQUIRE_FALSE(frontier.contains(state(node1)));
     }
     SECTION("Contains Point more expensive") {
         multi_a_star::Frontier frontier{};
-        multi_a_star::Node node{{1, 0}, instance.h_table(), goal_sequence};
-        multi_a_star::Node node1{{1, 1}, instance.h_table(), goal_sequence};
-        frontier.push(node);
+        multi_a_star::Node node{{1, 0}, sequence};
+        multi_a_star::Node node1{{1, 1}, sequence};
+        frontier.push(node, state(node));
         // doesn't contain Node
-        REQUIRE_FALSE(frontier.contains_more_expensive(node1, 0));
+        REQUIRE_FALSE(frontier.contains_more_expensive(state(node1), 0));
         // contains Node but cheaper
-        REQUIRE_FALSE(frontier.contains_more_expensive(node, 9));
+        REQUIRE_FALSE(frontier.contains_more_expensive(state(node), 9));
         // contains Node more expensive
-        REQUIRE(frontier.contains_more_expensive(node, 6));
+        REQUIRE(frontier.contains_more_expensive(state(node), 6));
     }
     SECTION("Replace a Node") {
         multi_a_star::Frontier frontier{};
-        multi_a_star::Node node{{1, 0}, instance.h_table(), goal_sequence};
-        multi_a_star::Node node1{{1, 1}, instance.h_table(), goal_sequence};
+        multi_a_star::Node node{{1, 0}, sequence};
+        multi_a_star::Node node1{{1, 1}, sequence};
         // Replace node that's not in the frontier
-        REQUIRE_THROWS(frontier.replace(node, node));
+        REQUIRE_THROWS(frontier.replace(state(node), node, state(node)));
         // Simple replace
-        frontier.push(node);
-        frontier.replace(node, node1);
-        REQUIRE(frontier.contains(node1));
-        REQUIRE_FALSE(frontier.contains(node));
+        frontier.push(node, state(node));
+        frontier.replace(state(node), node1, state(node1));
+        REQUIRE(frontier.contains(state(node1)));
+        REQUIRE_FALSE(frontier.contains(state(node)));
         // Find and replace
         frontier = {};  // reset the frontier
-        frontier.push(node);
-        auto optional_node = frontier.contains_more_expensive(node, 5);
+        frontier.push(node, state(node));
+        auto optional_node = frontier.contains_more_expensive(state(node), 5);
         if (optional_node) {
             // replace node with node1
-            frontier.replace(optional_node.value(), node1);
+            frontier.replace(state(optional_node.value()), node1, state(node1));
+        }
+        REQUIRE(frontier.contains(state(node1)));
+        REQUIRE_FALSE(frontier.contains(state(node)));
+    }
+    SECTION("Decrease key") {
+        // the timestep isn't packed, as after the last constraint of a search
+        auto timeless_state = [](const multi_a_star::Node& node) {
+            return multi_a_star::pack_state(instance.cell_index(node.get_location()),
+                                            multi_a_star::any_timestep,
+                                            node.get_label());
+        };
+        multi_a_star::Frontier frontier{};
+        multi_a_star::Node root{{1, 1}, sequence};
+        // same location and label, but reached later
+        multi_a_star::Node waited{{1, 1}, root, 0};
+        REQUIRE(timeless_state(waited) == timeless_state(root));
+        REQUIRE(root.get_f_value() < waited.get_f_value());
+        frontier.push(root, timeless_state(root));
+        REQUIRE_FALSE(frontier.decrease_key(waited, timeless_state(waited)));
+        frontier = {};
+        frontier.push(waited, timeless_state(waited));
+        const multi_a_star::Node other{{1, 0}, sequence};
+        frontier.push(other, timeless_state(other));
+        REQUIRE(frontier.decrease_key(root, timeless_state(root)));
+        REQUIRE(frontier.size() == 2);
+        REQUIRE(frontier.pop().get_g_value() == 0);
+    }
+    SECTION("Nodes which visited different goals") {
+        multi_a_star::Frontier frontier{};
+        multi_a_star::Node root{{1, 2}, sequence};
+        multi_a_star::Node labelled_root{root};
+        labelled_root.increment_label();
+        // same location and timestep, but the child of labelled_root has a goal less to visit
+        multi_a_star::Node node{{1, 1}, root, 0};
+        multi_a_star::Node labelled{{1, 1}, labelled_root, 0};
+        REQUIRE(node == labelled);
+        REQUIRE(state(node) != state(labelled));
+        frontier.push(node, state(node));
+        frontier.push(labelled, state(labelled));
+        REQUIRE(frontier.size() == 2);
+        REQUIRE(frontier.contains(state(node)));
+        REQUIRE(frontier.contains(state(labelled)));
+        REQUIRE(frontier.pop().get_label() == 1);
+        REQUIRE(frontier.pop().get_label() == 0);
+    }
+    SECTION("Pop order doesn't depend on push order") {
+        std::vector<multi_a_star::Node> nodes;
+        for (int row = 0; row < instance.rows_number(); ++row) {
+            for (int col = 0; col < instance.columns_number(); ++col) {
+                if (instance.is_valid({row, col})) nodes.emplace_back(Point{row, col}, sequence);
+            }
         }
-        REQUIRE(frontier.contains(node1));
-        REQUIRE_FALSE(frontier.contains(node));
+        multi_a_star::Frontier frontier{};
+        multi_a_star::Frontier reversed_frontier{};
+        for (int i = 0; i < std::ssize(nodes); ++i) {
+            const auto& reversed{nodes[nodes.size() - 1 - i]};
+            frontier.push(nodes[i], state(nodes[i]));
+            reversed_frontier.push(reversed, state(reversed));
+        }
+        int last_f_value{0};
+        while (!frontier.empty()) {
+            const auto node{frontier.pop()};
+            REQUIRE(node.get_f_value() >= last_f_value);
+            REQUIRE(node == reversed_frontier.pop());
+            last_f_value = node.get_f_value();
+        }
+        REQUIRE(reversed_frontier.empty());
     }
 }
 
@@ -151,6 +380,27 @@ TEST_CASE("multi A* complete", "[multi A*]") {
         path_t expected_path{{1, 4}, {1, 3}, {1, 2}, {1, 1}, {2, 1}, {3, 1}};
         REQUIRE(path == expected_path);
     }
+    SECTION("Parking") {
+        // the agent can't stay in its goal at timestep 5, so it must arrive later
+        std::vector<Constraint> constraints;
+        for (const int cell : instance.neighbours(Point{3, 1})) {
+            constraints.push_back({.agent = 0,
+                                   .timestep = 5,
+                                   .from_position = instance.cell_point(cell),
+                                   .to_position = {3, 1}});
+        }
+        const std::vector<Point> goals{{3, 1}};
+        const auto path{multi_a_star::multi_a_star(0, {1, 1}, goals, instance, constraints)};
+        REQUIRE(std::ssize(path) == 7);
+        REQUIRE(path.back() == Point{3, 1});
+        REQUIRE(std::ssize(multi_a_star::sipp(0, {1, 1}, goals, instance, constraints)) == 7);
+    }
+    SECTION("Goals visited more than once") {
+        // the agent is in (1,1) at timestep 2 both waiting and coming back from (1,2)
+        const std::vector<Point> goals{{1, 2}, {1, 1}, {1, 2}};
+        const path_t expected_path{{1, 1}, {1, 2}, {1, 1}, {1, 2}};
+        REQUIRE(multi_a_star::multi_a_star(0, {1, 1}, goals, instance) == expected_path);
+    }
     SECTION("Timeout") {
         AmbientMapInstance bad_instance{"data/instance_6.txt", "data/map_6.txt"};
         std::vector<Point> goals{{3, 0}, {3, 4}};
@@ -158,4 +408,51 @@ TEST_CASE("multi A* complete", "[multi A*]") {
     }
 }
 
+TEST_CASE("SIPP", "[multi A*]") {
+    SECTION("No constraints") {
+        const std::vector<Point> goals{{1, 2}, {3, 3}};
+        const auto path{multi_a_star::sipp(0, {1, 0}, goals, instance)};
+        REQUIRE(std::ssize(path) == 6);
+        REQUIRE(path.front() == Point{1, 0});
+        REQUIRE(path.back() == Point{3, 3});
+        REQUIRE(std::ranges::find(path, Point{1, 2}) != path.cend());
+    }
+    SECTION("Same goal twice") {
+        const std::vector<Point> goals{{1, 2}, {1, 2}};
+        REQUIRE(multi_a_star::sipp(0, {1, 0}, goals, instance)
+                == multi_a_star::multi_a_star(0, {1, 0}, goals, instance));
+    }
+    SECTION("Constraints") {
+        const std::vector<Point> goals{{3, 1}};
+        const std::vector<Constraint> constraints{
+            {.agent = 0, .timestep = 2, .from_position = {1, 3}, .to_position = {2, 3}},
+            {.agent = 1, .timestep = 2, .from_position = {1, 3}, .to_position = {1, 2}}};
+        const auto path{multi_a_star::sipp(0, {1, 4}, goals, instance, constraints)};
+        const path_t expected_path{{1, 4}, {1, 3}, {1, 2}, {1, 1}, {2, 1}, {3, 1}};
+        REQUIRE(path == expected_path);
+    }
+    SECTION("Wait") {
+        // (1, 2) can't be entered in the timesteps 1 to 3
+        std::vector<Constraint> constraints;
+        for (int timestep = 1; timestep <= 3; ++timestep) {
+            for (const int cell : instance.neighbours(Point{1, 2})) {
+                constraints.push_back({.agent = 0,
+                                       .timestep = timestep,
+                                       .from_position = instance.cell_point(cell),
+                                       .to_position = {1, 2}});
+            }
+        }
+        const std::vector<Point> goals{{1, 2}};
+        const auto path{multi_a_star::sipp(0, {1, 1}, goals, instance, constraints)};
+        REQUIRE(path == multi_a_star::multi_a_star(0, {1, 1}, goals, instance, constraints));
+        REQUIRE(std::ssize(path) == 5);
+        REQUIRE(path.back() == Point{1, 2});
+    }
+    SECTION("Timeout") {
+        AmbientMapInstance bad_instance{"data/instance_6.txt", "data/map_6.txt"};
+        std::vector<Point> goals{{3, 0}, {3, 4}};
+        REQUIRE_THROWS(multi_a_star::sipp(0, {1, 1}, goals, bad_instance));
+    }
+}
+
 }  // namespace
\ No newline at end of file
@@ -53,4 +53,17 @@ TEST_CASE("advanced ortools test", "[ortools]") {
     REQUIRE(goal_sequences.at(2) == valid_path_2);
 }
 
+TEST_CASE("ortools test with tasks starting at the agents", "[ortools]") {
+    // every task of a MovingAI scenario starts where its agent is
+    const AmbientMapInstance instance{"data/moving_ai.scen", "data/moving_ai.map"};
+
+    std::vector<path_t> goal_sequences = assign_tasks(instance, 1);
+
+    REQUIRE(goal_sequences.size() == 2);
+    std::vector valid_path_0{Point{0, 0}, Point{0, 0}, Point{3, 4}};
+    std::vector valid_path_1{Point{0, 4}, Point{0, 4}, Point{3, 0}};
+    REQUIRE(goal_sequences.at(0) == valid_path_0);
+    REQUIRE(goal_sequences.at(1) == valid_path_1);
+}
+
 }  // namespace
@@ -36,4 +36,13 @@ TEST_CASE("pp_4", "[pp]") {
     std::vector<path_t> final_temp_paths = pp::pp(instance, goal_sequences).paths;
     REQUIRE_NOTHROW(are_valid_routes(final_temp_paths));
 }
+
+TEST_CASE("pp with sipp", "[pp]") {
+    const AmbientMapInstance instance{"data/instance_3.txt", "data/map_3.txt"};
+    std::vector<path_t> goal_sequences = assign_tasks(instance, 2);
+
+    const CmapdSolution solution{pp::pp(instance, goal_sequences, Planner::SIPP)};
+    REQUIRE_NOTHROW(are_valid_routes(solution.paths));
+    REQUIRE(solution.cost == pp::pp(instance, goal_sequences).cost);
+}
 }  // namespace
\ No newline at end of file